@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// A non-owning reference to an agent. It stays cheap to copy into queued
+// events, and is checked against the registry before such an event runs.
+typedef struct AgentHandle {
+  std::uint32_t slot;
+  std::uint32_t generation;
+} AgentHandle;
+
+// Hands out AgentHandle's for the agents of one trajectory. Releasing a
+// handle bumps the generation of its slot, so every copy of that handle
+// still sitting in the event queue becomes invalid at once, and the slot
+// can be reused by the next agent. Not thread-safe: each TBABM owns one.
+class AgentRegistry {
+  public:
+    AgentHandle Acquire(void) {
+      if (free_slots.empty()) {
+        generations.push_back(0);
+        return {static_cast<std::uint32_t>(generations.size() - 1), 0};
+      }
+
+      auto slot = free_slots.back();
+      free_slots.pop_back();
+
+      return {slot, generations[slot]};
+    }
+
+    void Release(AgentHandle h) {
+      if (!Valid(h))
+        return;
+
+      generations[h.slot] += 1;
+      free_slots.push_back(h.slot);
+    }
+
+    bool Valid(AgentHandle h) const {
+      return h.slot < generations.size() && \
+             generations[h.slot] == h.generation;
+    }
+
+  private:
+    std::vector<std::uint32_t> generations;
+    std::vector<std::uint32_t> free_slots;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "TBABM.h"
+
+using std::string;
+
+// Lets a run that is killed part-way, e.g. on a preemptible partition,
+// carry on from where it was, a trajectory at a time.
+//
+// Each trajectory's outputs are saved under 'dir' as soon as it has been
+// exported: written to a temporary directory, which is then renamed into
+// place, so a trajectory is either all there or not at all. A run started
+// again with the same arguments and 'dir' restores trajectories that are
+// there instead of running them, and runs the rest. A trajectory's state
+// mid-run (its event queue, and the closures on it) can't be saved, so one
+// that was in flight starts again from its seed, and gives the results it
+// would have; the master seed is kept in 'dir' so that its seed is the
+// same even without -s.
+//
+// Outputs are only written to their usual places once every job is done,
+// by merging each job's trajectories, in order; 'dir' is then removed.
+class Checkpoint {
+  public:
+    // Creates 'dir' if need be, and removes anything half-written in it.
+    // Reads which trajectories were in flight when the run was last
+    // stopped, if it was stopped by a signal. Exits if it can't be created.
+    explicit Checkpoint(const string& dir);
+
+    // The master seed of the run checkpointed, if there is one; otherwise,
+    // records 'seed' as that and returns it. Exits if 'seed' was 'given'
+    // explicitly and isn't the one checkpointed.
+    std::uint_fast64_t Seed(std::uint_fast64_t seed, bool given);
+
+    // Whether trajectory 'i' of 'job' was saved. If so, 'values' are the
+    // --adaptive target values saved with it.
+    bool Restore(const string& job, int i, std::vector<double>& values) const;
+
+    // Whether trajectory 'i' of 'job' was in flight when the run was last
+    // stopped. Those are started first: they are what was left running,
+    // under longest-first ordering the longest of what remains.
+    bool Interrupted(const string& job, int i) const;
+
+    // Trajectory 'i' of 'job', of 'seed', has been started. Warns if it
+    // was interrupted with a different seed, i.e. the arguments changed.
+    void Started(const string& job, int i, std::uint_fast64_t seed);
+
+    // Saves trajectory 'i' of 'job', and the target 'values' of it, and
+    // marks it as no longer in flight. Not thread-safe with itself.
+    bool Save(const string& job, int i, std::shared_ptr<TrajectoryResult> t,
+              const std::vector<double>& values);
+
+    // Trajectory 'i' of 'job' is no longer in flight, and wasn't saved
+    void Abandon(const string& job, int i);
+
+    // Merges trajectories 0 to n-1 of 'job' into the outputs at 'prefix',
+    // after those of every job merged into 'prefix' before it
+    bool Merge(const string& job, const string& prefix, int n);
+
+    // Removes 'dir' and everything in it
+    void Remove(void);
+
+    // From now on, SIGTERM and SIGINT are handled by a thread of their own,
+    // which writes 'in-flight.csv' (job, trajectory, seed) to 'dir' and
+    // exits. The next run reads it (see Interrupted). Must be called
+    // before any other threads are started.
+    void HandleSignals(void);
+
+  private:
+    string dir;
+
+    string path(const string& job, int i) const;
+    std::size_t writeInFlight(void); // Returns how many there are
+
+    std::mutex mutex;
+    std::map<std::pair<string, int>, std::uint_fast64_t> in_flight;
+    std::map<std::pair<string, int>, std::uint_fast64_t> interrupted; // As the last run left them
+
+    std::map<string, std::set<string>> merged; // Of each output prefix
+};
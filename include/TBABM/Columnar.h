@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using std::string;
+
+// A binary, columnar form of TBABM's CSV outputs, which downstream tools
+// can read without parsing text: viz/R/utils_columnar.R reads it into R,
+// and ConvertOutputs turns it back into CSV.
+//
+// A file is a schema, then chunks of rows until the end of the file, so
+// it can be written a chunk at a time and read back the same way:
+//
+//   "TBABMCOL"  u32 version  u32 columns
+//   per column: u32 length, name, u8 type
+//   per chunk:  u32 rows, then per column:
+//               u8 codec (0 none, 1 zlib), u32 size, u32 stored size, data
+//
+// Numbers are little-endian. Int32 and Int64 columns are arrays of their
+// values, with the least value standing for a missing one (as R's
+// NA_integer_ does); Double columns are IEEE doubles, NaN if missing; a
+// String column's values are each followed by a NUL. Each column of a
+// chunk is compressed with zlib unless that doesn't make it any smaller.
+namespace Columnar {
+
+enum class Type : std::uint8_t { Int32, Int64, Double, String };
+
+struct Column {
+  string name;
+  Type type;
+};
+
+// A chunk's values, column by column. Integers of both widths are in
+// 'ints', whatever their type.
+struct Chunk {
+  std::size_t rows {0};
+  std::vector<std::vector<std::int64_t>> ints;
+  std::vector<std::vector<double>> doubles;
+  std::vector<std::vector<string>> strings;
+
+  // Value 'row' of column 'col' as CSV text; a missing value is empty
+  string Text(const std::vector<Column>& schema, std::size_t col, std::size_t row) const;
+};
+
+class Writer {
+  public:
+    // Opens 'path' and writes the schema. Rows are buffered and written
+    // 'chunk_rows' at a time.
+    Writer(const string& path, const std::vector<Column>& schema,
+           std::size_t chunk_rows = 1 << 16);
+    ~Writer(void);
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // Adds a row of 'fields', one per column, as text. An empty field is
+    // a missing value. False if one can't be read as its column's type.
+    bool Add(const std::vector<string>& fields);
+
+    // Writes what is buffered, and closes the file
+    bool Close(void);
+
+    bool Ok(void) const { return file && ok; }
+
+  private:
+    bool flush(void);
+    bool put(const void *data, std::size_t size);
+
+    FILE *file;
+    bool ok {true};
+    std::vector<Column> schema;
+    std::size_t chunk_rows;
+    Chunk chunk;
+};
+
+class Reader {
+  public:
+    explicit Reader(const string& path);
+    ~Reader(void);
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    // False if the file couldn't be opened, or isn't in this format
+    bool Ok(void) const { return file && ok; }
+
+    const std::vector<Column>& Schema(void) const { return schema; }
+
+    // Reads the next chunk into 'chunk'. False at the end of the file, or
+    // if it is corrupt, in which case Ok() is too.
+    bool Next(Chunk& chunk);
+
+  private:
+    bool get(void *data, std::size_t size);
+
+    FILE *file;
+    bool ok {true};
+    std::vector<Column> schema;
+};
+
+// Writes the CSV file 'csv' (one header line, as TBABM writes them) to
+// 'path' in this format. Each column is given the narrowest type all of
+// its values can be read as: Int32, Int64, Double, or else String. An
+// integer beyond Int64 makes its column String, not Double, so that no
+// digits of it are lost.
+bool FromCSV(const string& csv, const string& path);
+
+// Whether the file 'path' holds exactly the values of the CSV file 'csv',
+// row by row, as FromCSV would have read them
+bool Verify(const string& csv, const string& path);
+
+// Writes the file 'path' to 'out' as CSV, with a header line
+bool ToCSV(const string& path, FILE *out);
+
+} // namespace Columnar
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <RNG.h>
+#include <JSONImport.h>
+
+#include "ParamTable.h"
+
+using std::string;
+using StatisticalDistributions::RNG;
+
+enum class FrameID : std::size_t {
+#define TBABM_FRAME(name, required) name,
+#include "FrameNames.inc"
+#undef TBABM_FRAME
+  Count
+};
+
+// A DataFrameFile, compiled at load time into a dense (year x sex x age)
+// array of cells. Each cell holds its distribution already resolved to a
+// kind and its parameters, so 'getValue' is three integer divisions, one
+// array access, and one draw.
+//
+// The frame's first two rows are its header: the first holds the width of
+// a year and of an age category ('-' if the frame has no year dimension),
+// the second the number of categories. Coordinates outside the frame are
+// clamped to its first or last category, as DataFrameFile does, and a
+// frame without a year or sex dimension ignores that coordinate.
+class CompiledFrame {
+  public:
+    CompiledFrame(void) = default;
+    CompiledFrame(const json& frame, const char *name);
+
+    double getValue(double year, int sex, double age, RNG& rng) const;
+
+  private:
+    enum class Kind { Constant, Bernoulli, Exponential, Weibull, JohnsonSb };
+
+    struct Cell {
+      Kind kind;
+      double p[4];
+    };
+
+    std::size_t Index(double year, int sex, double age) const;
+
+    bool has_year {false};
+    bool has_sex  {false};
+
+    double year_start {0};
+    double year_width {1};
+    int    n_years    {1};
+
+    double age_start {0};
+    double age_width {1};
+    int    n_ages    {1};
+
+    std::vector<Cell> cells;
+};
+
+// Every frame the model reads, indexed by FrameID. Throws
+// std::runtime_error, listing them, if required frames are missing from
+// the runsheet, or naming the frame if one is malformed.
+class FrameTable {
+  public:
+    FrameTable(const ParamTable::FileList& files);
+
+    const CompiledFrame& operator[](FrameID id) const {
+      return table[static_cast<std::size_t>(id)];
+    }
+
+    static const char *Name(FrameID id);
+
+  private:
+    std::array<CompiledFrame, static_cast<std::size_t>(FrameID::Count)> table;
+};
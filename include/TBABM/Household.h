@@ -1,6 +1,9 @@
 #pragma once
 
 #include <cassert>
+#include <functional>
+#include <map>
+#include <vector>
 
 #include <RNG.h>
 #include <Param.h>
@@ -24,6 +27,9 @@ class Household {
 
     void PrintHousehold(int t);
 
+    // Its key in the trajectory's households, numbered from 0 as created
+    int ID(void) const { return hid; }
+
     bool can_trace = false;
     int n_contact_traces = 0;
 
@@ -57,15 +63,25 @@ class Household {
     // Returns true iff one of the members of the household is HIV+ or <5yo
     bool HasVulnerable(int t);
 
+    // A draw of whether a household is visited, or a member screened.
+    // The caller draws through ParamTable::Sample, so that folded
+    // parameters and --legacy-rng apply.
+    using Draw = std::function<bool(void)>;
+
     // Do a contact trace on the household. Returns the number of cases
     // of active, untreated TB in the household (NOT including the 
     // individual causing the tracing event to occur)
     ContactTraceResult
     ContactTrace(const int& t,
-                 const shared_p<Individual> idv,
-                 Param& frac_screened,
-                 Param& frac_visited,
-                 RNG& rng);
+                 const TB* index,
+                 const Draw& screened,
+                 const Draw& visited);
+
+    // Called when a member of the household ('index') develops active TB,
+    // or stops being infectious. Progression triggers a TB risk
+    // re-evaluation for every other member of the household.
+    void TBProgression(int t, const TB* index);
+    void TBRecovery(int t);
 
     Household(shared_p<Individual> head,
         shared_p<Individual> spouse,
@@ -102,5 +118,68 @@ class Household {
     int nIndividuals;
     int nInfectiousTBIndivduals;
 
-    void TriggerReeval(int t, weak_p<Individual> idv);
+    void TriggerReeval(int t, const TB* index);
+};
+
+// The households of a trajectory, by ID. IDs are handed out densely from
+// 0 (nHouseholds++), so a household is found by indexing, not searching.
+// As with the std::map this replaces, indexing an ID past the end makes
+// room for it, and an empty household is a null pointer. No household
+// has a negative ID.
+class HouseholdTable {
+  public:
+    using iterator = std::vector<shared_p<Household>>::iterator;
+
+    shared_p<Household>& operator[](long hid) {
+      assert(hid >= 0);
+
+      if (static_cast<std::size_t>(hid) >= table.size())
+        table.resize(hid + 1);
+
+      return table[hid];
+    }
+
+    // nullptr if there is no household 'hid'
+    Household* Find(long hid) const {
+      return hid >= 0 && static_cast<std::size_t>(hid) < table.size() ? \
+             table[hid].get() : nullptr;
+    }
+
+    std::size_t size(void) const { return table.size(); }
+
+    iterator begin(void) { return table.begin(); }
+    iterator end(void)   { return table.end(); }
+
+  private:
+    std::vector<shared_p<Household>> table;
+};
+
+// Entry point through which a TB object reaches the household it lives in.
+// A TB holds only the ID of its household, so moving an individual between
+// households never has to rebind anything on the TB side. Every method
+// tolerates an ID that does not (or no longer) map to a household.
+class HouseholdService {
+  public:
+    HouseholdService(HouseholdTable& households) :
+      households(households) {}
+
+    ContactTraceResult ContactTrace(long hid,
+                                    const int& t,
+                                    const TB* index,
+                                    const Household::Draw& screened,
+                                    const Household::Draw& visited);
+
+    void TBProgression(long hid, int t, const TB* index);
+    void TBRecovery(long hid, int t);
+
+    double ActiveTBPrevalence(long hid);
+    double ContactActiveTBPrevalence(long hid, TBStatus);
+
+    int infectiousIndividualsUnderAge(long hid, int maxage, int t);
+    int individualsUnderAge(long hid, int maxage, int t);
+
+  private:
+    Household* Lookup(long hid) { return households.Find(hid); }
+
+    HouseholdTable& households;
 };
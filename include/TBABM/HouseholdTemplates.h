@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "IndividualTypes.h"
+
+// The households of a household structure file, stored as flat arrays of
+// role, sex and age, with one offset per household into them.
+//
+// A compiled template file (see CompileHouseholds) holds exactly those
+// arrays, and is memory-mapped read-only, so that every trajectory and
+// every process on a node shares one copy of it. Any other file is parsed
+// as a household structure CSV, as HouseholdGen always has.
+//
+// Compiled file layout, in host byte order:
+//   Header                                 (magic, n_families, n_members)
+//   std::uint32_t offsets[n_families + 1]
+//   std::uint8_t  roles[n_members]        (HouseholdPosition)
+//   std::uint8_t  sexes[n_members]        (Sex)
+//   std::int16_t  ages[n_members]
+class HouseholdTemplates {
+  public:
+    struct Member {
+      HouseholdPosition role;
+      Sex sex;
+      int age;
+    };
+
+    // A view of one household. Cheap to copy; valid as long as the
+    // HouseholdTemplates it came from.
+    class Family {
+      public:
+        std::size_t size(void) const { return end - begin; }
+
+        Member operator[](std::size_t i) const {
+          return {static_cast<HouseholdPosition>(t.roles[begin+i]),
+                  static_cast<Sex>(t.sexes[begin+i]),
+                  t.ages[begin+i]};
+        }
+
+      private:
+        friend class HouseholdTemplates;
+
+        Family(const HouseholdTemplates& t, std::uint32_t begin,
+                                            std::uint32_t end) :
+          t(t), begin(begin), end(end) {};
+
+        const HouseholdTemplates& t;
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+
+    // Throws std::runtime_error if 'file' can't be read, has no households,
+    // or is a malformed compiled file (one with an empty household among
+    // them). Households of nobody in a CSV are skipped.
+    explicit HouseholdTemplates(const char *file);
+    ~HouseholdTemplates(void);
+
+    HouseholdTemplates(const HouseholdTemplates&) = delete;
+    HouseholdTemplates& operator=(const HouseholdTemplates&) = delete;
+
+    std::size_t size(void) const { return n_families; }
+
+    Family operator[](std::size_t i) const {
+      return Family(*this, offsets[i], offsets[i+1]);
+    }
+
+    bool Mapped(void) const { return mapping != nullptr; }
+
+    // Writes the templates as a compiled file. Returns false on failure.
+    bool Write(const char *file) const;
+
+  private:
+    struct Header {
+      char magic[8];
+      std::uint32_t n_families;
+      std::uint32_t n_members;
+    };
+
+    static const char Magic[8];
+
+    bool Map(const char *file);
+    void ParseCSV(const char *file);
+
+    // Storage for templates parsed from a CSV. Empty if mapped.
+    std::vector<std::uint32_t> offsets_v;
+    std::vector<std::uint8_t>  roles_v;
+    std::vector<std::uint8_t>  sexes_v;
+    std::vector<std::int16_t>  ages_v;
+
+    // Point into the mapping, or into the vectors above
+    const std::uint32_t *offsets {nullptr};
+    const std::uint8_t  *roles   {nullptr};
+    const std::uint8_t  *sexes   {nullptr};
+    const std::int16_t  *ages    {nullptr};
+
+    std::uint32_t n_families {0};
+    std::uint32_t n_members  {0};
+
+    void *mapping {nullptr};
+    std::size_t mapping_size {0};
+};
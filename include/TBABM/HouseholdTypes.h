@@ -1,5 +1,7 @@
 #pragma once
 
+class HouseholdService;
+
 typedef struct {
   int  cases_found;
   int  cases_found_hiv;
@@ -15,6 +15,7 @@
 #include "IndividualTypes.h"
 #include "TBTypes.h"
 #include "TB.h"
+#include "Names.h"
 
 using Time = int;
 using std::vector;
@@ -23,6 +24,7 @@ using EQ = EventQueue<double, bool>;
 
 class Individual : public std::enable_shared_from_this<Individual> {
   public:
+    long id {-1}; // Numbered from 0 as it joins the population of its trajectory
     long householdID;
 
     int birthDate; // In units of 't'
@@ -41,7 +43,7 @@ class Individual : public std::enable_shared_from_this<Individual> {
 
     MarriageStatus marriageStatus;
 
-    string Name(void) { return name; };
+    const string& Name(void) { return Names::lookup(name); };
 
     // HIV stuff
     int t_HIV_infection;
@@ -81,7 +83,7 @@ class Individual : public std::enable_shared_from_this<Individual> {
         [this] (void) -> bool         { return !dead; },
 
         // CD4 count
-        [this] (Time t) -> double     { return CD4count(t, params["HIV_m_30"].Sample(rng)); },
+        [this] (Time t) -> double     { return CD4count(t, params.Sample(ParamID::HIV_m_30, rng)); },
 
         // HIV status
         [this] (void) -> HIVStatus    { return hivStatus; },
@@ -90,10 +92,7 @@ class Individual : public std::enable_shared_from_this<Individual> {
         [this] (void) -> bool         { return onART; },
 
         // Global TB prevalence
-        [this] (Time t) -> double     { return handles.GlobalTBPrevalence(t); },
-
-        // Lifetime pointer
-        [this] (void) -> shared_p<TB> { return shared_p<TB>(shared_from_this(), &this->tb); }
+        [this] (Time t) -> double     { return handles.GlobalTBPrevalence(t); }
       );
     }
 
@@ -108,10 +107,11 @@ class Individual : public std::enable_shared_from_this<Individual> {
       return offspring.size();
     }
 
-    // Shorthand, assumes that "HIV_m_30" is a constant. The second definition
+    // Shorthand, assumes that "HIV_m_30" is a constant (and so folded by the
+    // ParamTable, rather than sampled on every call). The second definition
     // should be eliminated, but first references to it must be changed
     double CD4count(double t_cur) {
-      return CD4count(t_cur, params["HIV_m_30"].Sample(rng));
+      return CD4count(t_cur, params.Sample(ParamID::HIV_m_30, rng));
     }
 
     double CD4count(double t_cur, double m_30) {
@@ -165,7 +165,7 @@ class Individual : public std::enable_shared_from_this<Individual> {
     Individual(IndividualSimContext isc,
         MasterData& data,
         IndividualHandlers handles_,
-        string name,
+        NameID name,
         long householdID_, int birthDate, Sex sex,
         weak_p<Individual> spouse,
         weak_p<Individual> mother,
@@ -204,7 +204,7 @@ class Individual : public std::enable_shared_from_this<Individual> {
     Individual(IndividualSimContext isc,
         MasterData& data,
         IndividualHandlers handles,
-        string name,
+        NameID name,
         long hid, 
         int birthDate, 
         Sex sex, 
@@ -227,11 +227,11 @@ class Individual : public std::enable_shared_from_this<Individual> {
           marriageStatus) {
       };
   private:
-    string name;
+    NameID name;
     EQ& event_queue;
     RNG& rng;
-    map<string, DataFrameFile>& fileData;
-    Params& params;
+    const FrameTable& fileData;
+    ParamTable& params;
 
     IndividualHandlers handles;
 
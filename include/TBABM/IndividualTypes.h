@@ -8,8 +8,9 @@
 #include <EventQueue.h>
 #include <RNG.h>
 #include <Param.h>
-#include <DataFrame.h>
 #include "Pointers.h"
+#include "ParamTable.h"
+#include "FrameTable.h"
 
 using namespace boost::histogram;
 using namespace SimulationLib;
@@ -17,11 +18,12 @@ using StatisticalDistributions::RNG;
 using std::function;
 using std::map;
 using EQ = EventQueue<double, bool>;
-using Params = map<string, Param>;
 
 using Time = int;
 
 class Individual;
+class HouseholdService;
+class AgentRegistry;
 
 enum class Sex {
   Male, Female
@@ -59,14 +61,18 @@ typedef struct IndividualSimContext {
   int current_time;
   EQ& event_queue;
   RNG &rng;
-  map<string, DataFrameFile>& fileData;
-  Params& params;
+  const FrameTable& fileData;
+  ParamTable& params;
+  HouseholdService& households;
+  AgentRegistry& agents;
 } IndividualSimContext;
 
 IndividualSimContext CreateIndividualSimContext(
     int current_time, 
     EQ& event_queue, 
     RNG &rng,
-    map<string, DataFrameFile>& fileData,
-    Params& params
+    const FrameTable& fileData,
+    ParamTable& params,
+    HouseholdService& households,
+    AgentRegistry& agents
 );
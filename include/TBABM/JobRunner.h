@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <JSONImport.h>
+
+#include "Model.h"
+#include "RunOutputs.h"
+#include "Targets.h"
+#include "MemoryBudget.h"
+#include "utils/workstealing.h"
+#include "utils/mpscqueue.h"
+
+using std::string;
+
+class Checkpoint;
+class Shards;
+class SQLiteOutputs;
+
+// Runs jobs, each a runsheet's trajectories, on a pool of threads. At most
+// 'lookahead' jobs are on the pool at once, so that the next one can be
+// loaded while those simulate. Finished trajectories are handed to a
+// single writer thread, which does all of the formatting and I/O; a job
+// with outputs of its own has them written as soon as its last trajectory
+// is, while later jobs carry on.
+//
+//   JobRunner runner(options, checkpoint, database, shards, reportDone, combined, prefix);
+//   for (each job)
+//     runner.Submit(std::move(job));
+//   bool ok = runner.Finish();
+class JobRunner {
+  public:
+    struct Options {
+      int pool_size {1};
+      bool pin {false};
+      std::size_t first_cpu {0};      // Worker processes pin to CPUs of their own
+
+      std::size_t memory_budget {0};  // See MemoryBudget
+      double bytes_per_agent_year {80};
+
+      string timings_file;            // Of trajectories' seconds, by timings_key; "" for none
+
+      std::vector<Target> targets;    // Under --adaptive
+      int min_trajectories {4};
+      double tolerance {0.05};
+      bool relative_tolerance {true};
+
+      int lookahead {2};
+      bool columnar {false};          // Outputs are made columnar once written
+      string jobs_csv;                // Which trajectory belongs to which job; "" for none
+    };
+
+    // What a job is to run, and where its outputs go
+    struct JobSpec {
+      string id;
+      string spec;
+      string timings_key;
+      string prefix;                        // Of its outputs
+      std::shared_ptr<RunOutputs> outputs;  // nullptr under --checkpoint
+      std::shared_ptr<const Model> model;
+      std::uint_fast64_t seed;              // Its seeds are drawn from
+      std::vector<std::uint_fast64_t> seeds; // Of every trajectory it may run
+      json sheet;                           // Only needed for --sqlite
+      double cost;            // Of a trajectory, unless timed before
+      std::size_t first_item; // Its first trajectory's claim, with --processes
+    };
+
+    // Called with a completion line for each job; see --serve
+    using Report = std::function<void(const json&)>;
+
+    // Any of 'checkpoint', 'database' and 'shards' may be nullptr. Jobs
+    // whose outputs are 'combined' are written together, to 'prefix', by
+    // Finish.
+    JobRunner(const Options& options,
+              Checkpoint *checkpoint,
+              SQLiteOutputs *database,
+              Shards *shards,
+              Report report,
+              std::shared_ptr<RunOutputs> combined,
+              const string& prefix);
+
+    // Finishes, if Finish() hasn't been called
+    ~JobRunner(void);
+
+    JobRunner(const JobRunner&) = delete;
+    JobRunner& operator=(const JobRunner&) = delete;
+
+    // Starts the trajectories of 'job', once there is room for it on the
+    // pool: until then, waits for the jobs ahead of it to finish.
+    void Submit(JobSpec&& job);
+
+    // Waits for every job, and writes what is left to write. False if any
+    // output failed to be written.
+    bool Finish(void);
+
+  private:
+    struct Job;
+
+    // A trajectory's results, or a block of its survey rows, on their way
+    // to the writer
+    struct Finished {
+      std::shared_ptr<Job> job; // nullptr: no more to come
+      int i;
+      std::unique_ptr<TrajectoryResult> result; // nullptr: Run() failed
+      std::vector<double> values;               // Of its --adaptive targets
+
+      // Or, if there are 'rows', the trajectory hasn't finished: this is a
+      // block of rows of one of its surveys
+      SurveyKind survey;
+      string rows;
+    };
+
+    void launch(std::shared_ptr<Job> job, int i);
+    void wait(std::shared_ptr<Job> job, int i);
+    void admit(void);
+    void run(std::shared_ptr<Job> job, int i, double cost);
+    void join(void);
+    void write(void);
+
+    Options options;
+    Checkpoint *checkpoint;
+    SQLiteOutputs *database;
+    Shards *shards;
+    Report report;
+    std::shared_ptr<RunOutputs> combined;
+    string prefix;
+
+    MemoryBudget memory;
+
+    // Trajectories launched but not yet admitted to the pool, costliest
+    // first. The admitter hands them over as they fit in memory.
+    std::mutex admission_mutex;
+    std::condition_variable admission;
+    std::multimap<double, std::pair<std::shared_ptr<Job>, int>, std::greater<double>> waiting;
+    bool stopping {false};
+    std::thread admitter;
+
+    // Reset by Finish, once every job is joined, to wait for the last
+    // tasks to hand their results to the writer
+    std::unique_ptr<WorkStealingPool> pool;
+
+    // A trajectory only blocks if the writer has fallen this far behind;
+    // the queue bounds how many unwritten results can pile up in memory
+    MPSCQueue<Finished> finished;
+    std::atomic<bool> export_failed {false};
+    std::thread writer;
+
+    std::deque<std::shared_ptr<Job>> in_flight;
+    std::ofstream jobs_file;
+
+    // Under --checkpoint, each job joined is merged from it at the end: its
+    // id, output prefix and number of trajectories
+    std::vector<std::tuple<string, string, int>> to_merge;
+};
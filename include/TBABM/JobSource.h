@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <JSONImport.h>
+
+using std::string;
+
+// One runsheet to run, and how
+struct JobRequest {
+  string id;             // Names the job in outputs and completion lines
+  string spec;           // Runsheet, in any form '-p' accepts
+  json sheet;            // ...or the runsheet itself, if not null
+  json set;              // {short-name: value}s, substituted as 'parameter-1'
+
+  bool has_seed {false}; // Otherwise, seeds come from the master RNG
+  std::uint64_t seed {0};
+
+  int trajectories {-1}; // Negative for the '-t' default
+  string output;         // Output prefix; empty for the default
+
+  string error;          // Why the request was rejected, if it was
+};
+
+// Reads the runsheet 'spec', in any of the forms '-p' accepts. The last
+// bundle read from is kept open, as a batch usually draws many runs from
+// one bundle. Throws if 'spec' can't be read: std::runtime_error, or
+// whatever JSONImport throws for malformed JSON.
+json LoadRunsheet(const string& spec);
+
+// The runsheet of 'request': its spec or inline sheet, with its 'set'
+// substitutions made. Returns false, with 'error' set, if the spec can't
+// be read, or a 'set' name isn't in the runsheet.
+bool LoadRunsheet(const JobRequest& request, json& sheet, string& error);
+
+// Jobs, read a line at a time from a file, a FIFO, or stdin ('-'), so that
+// a long list or a pipe need not be read up front. Blank lines, and lines
+// starting with '#', are skipped.
+//
+// A line is either a runsheet spec, or a JSON object:
+//
+//   {"id": "a1", "runsheet": "run.json" | [rows...],
+//    "set": {"TB_beta": 0.3}, "seed": 12, "trajectories": 4,
+//    "output": "out/a1/"}
+//
+// of which only "runsheet" is required. A bundle named without '#k' stands
+// for every run in it.
+//
+// With 'resident' set, the end of a FIFO is not the end of the jobs: it is
+// reopened, to wait for the next writer. Only end of file on stdin, or on
+// a regular file, ends a resident source.
+class JobSource {
+  public:
+    JobSource(const string& file, bool resident);
+
+    // False when there are no more jobs. A malformed line is returned with
+    // 'error' set, for the caller to report, rather than ending the source.
+    bool Next(JobRequest& request);
+
+  private:
+    bool ReadLine(string& line);
+
+    string file;
+    bool resident;
+    bool fifo {false};
+    std::unique_ptr<std::ifstream> owned;
+
+    string bundle_file;
+    std::uint32_t bundle_runs {0};
+    std::uint32_t bundle_next {0};
+};
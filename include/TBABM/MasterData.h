@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include <boost/histogram.hpp>
 #include <IncidenceTimeSeries.h>
 #include <PrevalenceTimeSeries.h>
@@ -96,6 +98,11 @@ class MasterData {
 
     MasterData(int tMax, int pLength, std::vector<double> ageBreaks);
 
+    // The time series or pyramid exported as 'name' (see OutputNames.inc),
+    // or nullptr if none is
+    TimeSeries<int> *Series(const std::string& name);
+    PyramidTimeSeries *Pyramid(const std::string& name);
+
     void Close(void);
     
   private:
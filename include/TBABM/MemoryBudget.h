@@ -0,0 +1,81 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using std::string;
+
+// Admits trajectories to run only while their estimated memory fits in
+// the process's budget, so that -m can be the number of cores without the
+// process being killed for running out of memory at large -n.
+//
+// A trajectory is estimated to need 'bytes per agent-year' times its
+// initial population size times the years it runs for, at its peak: the
+// population grows, and its time series, pyramids and any surveys it
+// keeps are added to every year. That starts from a prior, and is then
+// measured: a monitor thread samples the resident set size, and the most
+// it has been, above what it was when nothing was running, per agent-year
+// admitted, becomes the estimate if it is larger. The estimate therefore
+// also covers results waiting for the writer.
+//
+// Whatever the estimates say, nothing more is admitted while the resident
+// set is over the budget. One trajectory is always admitted if nothing
+// else is running, however large it is.
+class MemoryBudget {
+  public:
+    // 'budget' bytes, or if 0, 90% of Limit(), leaving room for the writer
+    // and the inputs of jobs loaded later
+    MemoryBudget(std::size_t budget, double bytes_per_agent_year);
+    ~MemoryBudget(void);
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    // Admits a trajectory of 'agents' for 'years' if it fits now
+    bool TryAdmit(double agents, double years);
+
+    // Blocks until what fits may have changed: a trajectory is released,
+    // or the resident set is sampled again
+    void Wait(void);
+
+    // A trajectory of 'agents' for 'years' has freed its population
+    void Release(double agents, double years);
+
+    std::size_t Budget(void) const { return budget; }
+
+    // The memory the process may use: the least of its cgroup's limit
+    // (v1 or v2), RLIMIT_AS and RLIMIT_DATA, and physical memory
+    static std::size_t Limit(void);
+
+    // The process's resident set size, in bytes
+    static std::size_t RSS(void);
+
+    // Parses a size such as '512M' or '16G'; a bare number is bytes. Exits
+    // if it is malformed.
+    static std::size_t ParseSize(const string& size);
+
+  private:
+    void monitor(void);
+    bool fits(double agent_years) const;
+
+    std::size_t budget;
+    std::size_t baseline; // Resident set before anything was admitted
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    double per_agent_year;    // The estimate in use
+    double prior;
+    double measured {0};      // Most bytes per agent-year seen so far
+    double admitted_agent_years {0};
+    double peak_agent_years {0}; // Most ever admitted at once
+    int admitted {0};
+    bool released {false};    // Has any trajectory finished?
+    std::size_t rss;
+    bool throttled {false};
+    bool stop {false};
+
+    std::thread sampler;
+};
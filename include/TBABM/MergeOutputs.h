@@ -0,0 +1,15 @@
+#pragma once
+
+#include <set>
+#include <string>
+
+using std::string;
+
+// Moves every file under the directory 'from' to the same path under
+// 'to', recursively, and removes the directories it empties; or, unless
+// 'move', copies them and leaves 'from' as it was. Outputs are
+// CSVs with one header line in long format, so a path already in 'merged'
+// is appended to without its header; any other replaces whatever is at its
+// destination, and is added to 'merged'.
+bool MergeOutputs(const string& from, const string& to, std::set<string>& merged,
+                  bool move);
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <JSONImport.h>
+
+#include "TBABM.h"
+#include "World.h"
+
+using std::string;
+
+// The results of a set of trajectories, in memory: everything RunOutputs
+// would otherwise write to CSV files.
+class Results {
+  public:
+    explicit Results(std::size_t n) : trajectories(n) {};
+
+    std::size_t Size(void) const { return trajectories.size(); }
+
+    // Whether trajectory 'i' ran to completion. Only then is there anything
+    // else to be had of it.
+    bool Ok(std::size_t i) const { return (bool)trajectories[i]; }
+
+    // Its seed, time series, pyramids, ctInfectiousnessAverted histogram,
+    // and survey rows
+    TrajectoryResult& operator[](std::size_t i) { return *trajectories[i]; }
+
+    // Its time series or pyramid exported as 'name' (see OutputNames.inc),
+    // or nullptr if none is, or it didn't complete
+    TimeSeries<int> *Series(std::size_t i, const string& name) {
+      return Ok(i) ? trajectories[i]->data.Series(name) : nullptr;
+    }
+
+    PyramidTimeSeries *Pyramid(std::size_t i, const string& name) {
+      return Ok(i) ? trajectories[i]->data.Pyramid(name) : nullptr;
+    }
+
+    // Hands trajectory 'i' over to the caller; nullptr if it didn't complete
+    std::unique_ptr<TrajectoryResult> Take(std::size_t i) {
+      return std::move(trajectories[i]);
+    }
+
+  private:
+    friend class Model;
+
+    std::vector<std::unique_ptr<TrajectoryResult>> trajectories;
+};
+
+// TBABM as a library: a runsheet, loaded once, of which any number of
+// trajectories can be run, on any threads, with nothing read or written
+// but the runsheet's own files and the household templates.
+//
+//   auto families = std::make_shared<const HouseholdTemplates>("household_structure.csv");
+//   Model model(sheet, Model::DefaultConstants(10000, 50), families);
+//
+//   WorkStealingPool pool(8);
+//   auto results = model.Run({1, 2, 3, 4}, [&pool] (std::function<void(void)> f) {
+//     pool.enqueue(1, f);
+//   });
+//
+//   double prevalence = (*results.Series(0, "hivPositive"))(365 * 20);
+//
+// The kind of contact tracing is still the process-wide 'trace_kind'.
+// A runsheet that is unusable (a required parameter or frame missing, or
+// a frame malformed) makes the constructor throw std::runtime_error; what
+// to do about it is the caller's to decide.
+class Model {
+  public:
+    using Constants = TBABM::Constants;
+
+    // Runs a task, on this thread or any other, now or later
+    using Executor = std::function<void(std::function<void(void)>)>;
+
+    // Frames already loaded, by the files they were loaded from
+    using FrameCache = std::map<ParamTable::FileList, std::shared_ptr<const FrameTable>>;
+
+    // Loads the runsheet 'sheet', as JSONImport gives it, and the frames it
+    // names, unless 'frames' has them already; they're added to 'frames'
+    // if not. See ParamTable::FoldConstants for 'legacy_rng'. Throws
+    // std::runtime_error if the runsheet is unusable.
+    Model(const json& sheet,
+          const Constants& constants,
+          std::shared_ptr<const HouseholdTemplates> families,
+          bool legacy_rng = false,
+          FrameCache *frames = nullptr);
+
+    // Runs trajectories of a World loaded elsewhere
+    Model(std::shared_ptr<const World> world, const Constants& constants) :
+      world(world), constants(constants) {};
+
+    // The constants the CLI runs 'populationSize' agents for 'years' with,
+    // unless told otherwise
+    static Constants DefaultConstants(int populationSize, int years);
+
+    // Runs the trajectory of 'seed'. nullptr if it fails. May be called
+    // from several threads at once. With a 'surveys' sink, survey rows are
+    // streamed to it in blocks of 'block' bytes as they're made, and the
+    // result has none (see TBABM::StreamSurveys).
+    std::unique_ptr<TrajectoryResult> Run(std::uint_fast64_t seed,
+                                          SurveySink surveys = nullptr,
+                                          std::size_t block = 1 << 20) const;
+
+    // Runs a trajectory of each of 'seeds', each as a task handed to
+    // 'executor', and waits for them all. Without an executor, runs them
+    // one after another on this thread. A trajectory whose task throws, or
+    // that the executor drops without running, is one that failed: the
+    // wait ends once every task has run or been destroyed.
+    Results Run(const std::vector<std::uint_fast64_t>& seeds,
+                const Executor& executor = nullptr) const;
+
+    std::shared_ptr<const World> SharedWorld(void) const { return world; }
+    const Constants& GetConstants(void) const { return constants; }
+
+  private:
+    // Run(seed), with an exception reported, and taken as failure
+    std::unique_ptr<TrajectoryResult> tryRun(std::uint_fast64_t seed) const;
+
+    std::shared_ptr<const World> world;
+    Constants constants;
+};
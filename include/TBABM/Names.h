@@ -1,25 +1,36 @@
 #pragma once
 
+#include <cstdint>
+
 #include <RNG.h>
 
 using std::vector;
 using std::string;
 
+// Agents store their name as an index into a single, process-wide table
+// which is shared by every trajectory. The string itself is only looked up
+// when something actually prints it (see TB::Log and HIVInfectionLogger).
+using NameID = std::uint16_t;
+
 class Names {
   public:
-    Names(vector<string> names_ = {}) {
-      if (names_.size() != 0)
-        names = names_;
-    };
-
-    string getName(RNG &rng) {
-      size_t length = names.size();
+    static NameID getName(RNG &rng) {
+      size_t length = table().size();
       auto num = rng.mt_();
 
-      return names.at(static_cast<size_t>(num) % length);
+      return static_cast<NameID>(static_cast<size_t>(num) % length);
+    }
+
+    static const string& lookup(NameID id) {
+      return table().at(id);
     }
 
   private:
-    vector<string> names = 
+    static const vector<string>& table(void) {
+      static const vector<string> names =
 #include "Names.inc"
+      ;
+
+      return names;
+    }
 };
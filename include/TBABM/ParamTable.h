@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Param.h>
+#include <RNG.h>
+#include <JSONImport.h>
+
+using namespace SimulationLib;
+using StatisticalDistributions::RNG;
+
+using std::string;
+
+enum class ParamID : std::size_t {
+#define TBABM_PARAM(name, required) name,
+#include "ParamNames.inc"
+#undef TBABM_PARAM
+  Count
+};
+
+// The parameters of a runsheet, resolved once at load time into a flat
+// array indexed by ParamID, so that model code never looks a parameter up
+// by its name. Parameters which map to a file are not part of the table;
+// their names and filenames are kept in 'Files()' for the caller to load.
+//
+// Parameters whose distribution is a point mass are additionally folded to
+// a plain value by 'FoldConstants', and 'Sample' returns that value without
+// touching the distribution (or the RNG).
+class ParamTable {
+  public:
+    using Params = std::map<string, Param>;
+    using FileList = std::vector<std::pair<string, string>>; // name, filename
+    using Value = decltype(std::declval<Param&>().Sample(std::declval<RNG&>()));
+
+    // Throws std::runtime_error, naming every missing required parameter,
+    // if there are any
+    ParamTable(const Params& params);
+
+    Param& operator[](ParamID id) {
+      return table[static_cast<std::size_t>(id)];
+    }
+
+    Value Sample(ParamID id, RNG& rng) {
+      auto i = static_cast<std::size_t>(id);
+
+      return folded[i] ? constants[i] : table[i].Sample(rng);
+    }
+
+    bool IsConstant(ParamID id) const {
+      return folded[static_cast<std::size_t>(id)];
+    }
+
+    // Inspects the rows of the runsheet 'sheet' was loaded from, and folds
+    // every 'Constant' parameter, as well as Bernoulli(0) and Bernoulli(1).
+    // Sampling a Bernoulli still draws from the RNG even when its outcome is
+    // certain, so folding one shifts the rest of the RNG stream; with
+    // 'legacy_rng' set, those are left alone, and the stream is identical to
+    // that of an unfolded table. Returns the number of parameters folded.
+    int FoldConstants(const json& sheet, bool legacy_rng);
+
+    const FileList& Files(void) const { return files; }
+
+    static const char *Name(ParamID id);
+
+  private:
+    static const std::size_t N = static_cast<std::size_t>(ParamID::Count);
+
+    std::array<Param, N> table;
+    std::array<bool,  N> folded {};
+    std::array<Value, N> constants {};
+    FileList files;
+};
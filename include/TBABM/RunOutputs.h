@@ -0,0 +1,73 @@
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <CSVExport.h>
+
+#include "TBABM.h"
+
+using std::string;
+using std::ofstream;
+
+// One output set: the time series and pyramids of OutputNames.inc, the
+// population, household and death surveys, and the ctInfectiousnessAverted
+// histogram of every trajectory added to it. Files are laid out under
+// 'prefix' exactly as TBABM has always written them, so several runsheets
+// can each have their own RunOutputs in one process, or share one.
+class RunOutputs {
+  public:
+    // Opens the survey and histogram files and writes their headers. If
+    // one can't be opened or written, Ok() is false, and so is everything
+    // that would write to the set.
+    explicit RunOutputs(const string& prefix);
+
+    RunOutputs(const RunOutputs&) = delete;
+    RunOutputs& operator=(const RunOutputs&) = delete;
+
+    // Writes the surveys and histogram of 't' straight away, and keeps its
+    // time series until Write(). They aren't copied: 't' is kept, less its
+    // surveys, for as long as the exporters have them. Not thread-safe.
+    bool Add(std::shared_ptr<TrajectoryResult> t);
+
+    // Writes a block of rows streamed from a trajectory that's still
+    // running. Not thread-safe.
+    bool AddSurveyRows(SurveyKind survey, const string& rows);
+
+    // Writes every time series and pyramid added so far, and flushes and
+    // closes the survey and histogram files
+    bool Write(void);
+
+    const string& Prefix(void) const { return prefix; }
+
+    // Whether every file was opened and given its header
+    bool Ok(void) const { return ok; }
+
+    // Replaces each CSV file of the output set at 'prefix' with its
+    // columnar form (see Columnar.h), <name>.tbc, once nothing more will be
+    // written or merged into it. A CSV that doesn't read back exactly is
+    // kept, and its .tbc removed.
+    static bool ToColumnar(const string& prefix);
+
+    // The header line of each survey file, by its name
+    static const std::map<string, string>& SurveyHeaders(void);
+
+    // Trajectories added successfully so far
+    int Added(void) const { return added; }
+
+  private:
+    string prefix;
+    int added {0};
+    bool ok {true};
+
+#define TBABM_SERIES(name, member) TimeSeriesExport<int> name;
+#define TBABM_PYRAMID(name, member) PyramidTimeSeriesExport name;
+#include "OutputNames.inc"
+#undef TBABM_PYRAMID
+#undef TBABM_SERIES
+
+    std::map<string, std::shared_ptr<ofstream>> surveyFiles;
+    std::map<string, std::shared_ptr<ofstream>> histFiles;
+};
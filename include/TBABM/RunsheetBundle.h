@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <JSONImport.h>
+
+using std::string;
+
+// N runsheets of a sweep in one file: a prototype runsheet, plus one
+// column of values per swept parameter, holding that parameter's
+// 'parameter-1' in each of the N runs. This is the same prototype and
+// substitution table that params/gen_runsheets.R produces, so a sweep is
+// one file rather than thousands of JSON runsheets.
+//
+// The file is memory-mapped read-only, and run 'k' is rebuilt on demand by
+// substituting row 'k' of each column into a copy of the prototype.
+//
+// Layout, in host byte order:
+//   Header
+//   char   prototype[prototype_size]        (runsheet, as JSON text)
+//   Column columns[n_columns]
+//   double values[n_columns][n_runs]        (column-major)
+class RunsheetBundle {
+  public:
+    // Throws std::runtime_error if 'file' can't be mapped, or isn't a
+    // well-formed bundle
+    explicit RunsheetBundle(const char *file);
+    ~RunsheetBundle(void);
+
+    RunsheetBundle(const RunsheetBundle&) = delete;
+    RunsheetBundle& operator=(const RunsheetBundle&) = delete;
+
+    std::uint32_t Runs(void) const { return header->n_runs; }
+
+    // The runsheet of run 'k', as if read by JSONImport::fileToJSON. Throws
+    // std::runtime_error if 'k' is out of range.
+    json Runsheet(std::uint32_t k) const;
+
+    // Writes a bundle of 'values.size()/names.size()' runs. 'values' holds
+    // one row per run, in the order of 'names'. Returns false, having
+    // printed why, if it fails.
+    static bool Write(const char *file,
+                      const json& prototype,
+                      const std::vector<string>& names,
+                      const std::vector<double>& values);
+
+    // Sets 'parameter-1' of the row of 'sheet' whose 'short-name' is
+    // 'name'. Returns false if there is no such row.
+    static bool Substitute(json& sheet, const string& name, double value);
+
+    // True if 'file' begins with the magic number of a runsheet bundle
+    static bool IsBundle(const char *file);
+
+    // Splits a '-p' argument of the form 'bundle.bin#k'. Returns false if
+    // 'arg' doesn't have that form.
+    static bool ParseSelector(const string& arg, string& file, std::uint32_t& k);
+
+  private:
+    static const std::size_t NameLength = 64;
+
+    struct Header {
+      char magic[8];
+      std::uint32_t n_runs;
+      std::uint32_t n_columns;
+      std::uint64_t prototype_size;
+    };
+
+    struct Column {
+      char name[NameLength]; // 'short-name', NUL-padded
+    };
+
+    static const char Magic[8];
+
+    const Header *header {nullptr};
+    const char   *prototype {nullptr};
+    const Column *columns {nullptr};
+    const double *values {nullptr};
+
+    void *mapping {nullptr};
+    std::size_t mapping_size {0};
+};
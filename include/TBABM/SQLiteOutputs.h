@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <JSONImport.h>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+using std::string;
+
+// Loads output sets into an SQLite database as they are written, in place
+// of DumpToDB. Every table has a fixed schema:
+//
+//   runs          (run, job, spec, seed, started)
+//   parameters    (run, name, distribution, p1, p2, p3, p4)
+//   trajectories  (run, trajectory, ok)
+//   series        (run, name, trajectory, period, value)
+//   pyramids      (run, name, trajectory, period, category, age_group, value)
+//   population, household, death
+//                 (run, then the columns of the survey's CSV)
+//   ctInfectiousnessAverted (run, trajectory, lower, upper, value)
+//
+// 'run' numbers the jobs recorded in the database, across every process
+// that has written to it. 'trajectory' is the trajectory's seed, as in
+// the CSVs. Tables of rows are indexed on (run, trajectory, period or
+// time).
+//
+// Rows are inserted with prepared statements, many to a transaction. It
+// isn't thread-safe: TBABM has it written only from its writer thread.
+// Loading an output set is done there too, synchronously, so while a
+// large set loads, the writer's queue fills, and trajectories that finish
+// (or stream survey rows) in the meantime wait for room on it.
+class SQLiteOutputs {
+  public:
+    // Opens 'path', creating it and its tables if need be. Exits if it
+    // can't.
+    explicit SQLiteOutputs(const string& path);
+    ~SQLiteOutputs(void);
+
+    SQLiteOutputs(const SQLiteOutputs&) = delete;
+    SQLiteOutputs& operator=(const SQLiteOutputs&) = delete;
+
+    // Records a job, and the parameters of its runsheet 'sheet', and
+    // returns its run number
+    std::int64_t AddRun(const string& job, const string& spec,
+                        std::uint_fast64_t seed, const json& sheet);
+
+    // Records trajectory 'seed' as being of 'run', and whether it was
+    // exported
+    bool AddTrajectory(std::int64_t run, std::uint_fast64_t seed, bool ok);
+
+    // Loads every file of the output set RunOutputs wrote at 'prefix',
+    // which is run 'run''s alone
+    bool Load(const string& prefix, std::int64_t run);
+
+    // Loads an output set that several runs were written to. Each row is
+    // given the run its trajectory was recorded with by AddTrajectory. A
+    // seed recorded for more than one run, as when jobs share a seed,
+    // can't be told apart in the set: its rows are loaded with a NULL run.
+    bool Load(const string& prefix);
+
+  private:
+    // Loads the output set at 'prefix', with every row's run 'run', or if
+    // it is negative, the run of the row's trajectory
+    bool loadSet(const string& prefix, std::int64_t run);
+
+    // Loads the CSV 'fname' into the statement 'insert', whose parameters
+    // are the run, then 'fixed', then the CSV's 'columns', in order
+    bool load(const string& fname, sqlite3_stmt *insert, std::int64_t run,
+              const std::vector<string>& fixed, const std::vector<string>& columns);
+
+    bool exec(const string& sql);
+    sqlite3_stmt *prepare(const string& sql);
+
+    sqlite3 *db {nullptr};
+
+    sqlite3_stmt *insertRun;
+    sqlite3_stmt *insertParameter;
+    sqlite3_stmt *insertTrajectory;
+    sqlite3_stmt *insertSeries;
+    sqlite3_stmt *insertPyramid;
+    sqlite3_stmt *insertHist;
+    std::map<string, sqlite3_stmt *> insertSurvey;
+
+    // The run of each trajectory recorded, by its seed as in the CSVs;
+    // -1 for a seed recorded for more than one run
+    std::map<long, std::int64_t> runs;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+using std::string;
+
+// Runs one TBABM as several processes on a node, with no MPI or network:
+// each worker has its own allocator and its own writer, and all of them
+// share one set of outputs once they're merged.
+//
+// The coordinator forks the workers once everything read-only has been
+// loaded: the household templates, and the Model of every queued job,
+// with its parameters and compiled frames. The workers share those pages
+// copy-on-write (and, for inputs that are mmap'd, such as compiled
+// household templates, the page cache).
+// Trajectories are handed out through a table of claim flags in anonymous
+// shared memory: every worker queues every trajectory, in the same order,
+// and whichever claims one first runs it; the rest skip it.
+//
+// Workers write their outputs to 'prefix + Dir(k)' rather than 'prefix'.
+// Every output is a CSV with one header line, in long format, so merging
+// is concatenation.
+class Shards {
+  public:
+    // Maps a claim flag for each of 'items' trajectories
+    explicit Shards(std::size_t items);
+    ~Shards(void);
+
+    Shards(const Shards&) = delete;
+    Shards& operator=(const Shards&) = delete;
+
+    // Forks 'n' workers. Returns this worker's index in each of them. In
+    // the coordinator, waits for every worker to exit, and returns -1;
+    // 'ok' is set if they all exited successfully. Must be called before
+    // any threads are started.
+    int Fork(int n, bool& ok);
+
+    // True for exactly one of the processes that claim 'item'
+    bool Claim(std::size_t item) {
+      return !claims[item].exchange(1, std::memory_order_relaxed);
+    }
+
+    // The directory, relative to an output prefix, of worker 'k'
+    static string Dir(int k);
+
+    // Appends every file under 'prefix + Dir(k)', for each k < n, to the
+    // same path under 'prefix', keeping the header line only where the
+    // destination is new; then removes the workers' directories
+    static bool Merge(const string& prefix, int n);
+
+  private:
+    std::atomic<unsigned char> *claims;
+    std::size_t size;
+};
@@ -5,24 +5,26 @@
 using IPt = shared_p<Individual>;
 using HPt = shared_p<Household>;
 
-string Ihash(IPt idv); // Hash of individual
-string Hhash(HPt hh);  // Hash of household
+// Each is a field of a survey row, as written to a CSVRow
 
-string age(IPt idv, int t); // Age (years)
-string sex(IPt idv); // Sex ("male"/"female")
+long ID(IPt idv); // Numbered within the trajectory, from 0
+long ID(HPt hh);  // Numbered within the trajectory, from 0
 
-string marital(IPt idv); // "single"/"married"/"divorced"/"looking"
-string numChildren(IPt idv);
-string mom(IPt idv); // "dead"/"alive"
-string dad(IPt idv); // "dead"/"alive"
+int age(IPt idv, int t); // Age (years)
+const char *sex(IPt idv); // Sex ("male"/"female")
 
-string causeDeath(DeathCause cause_death); // "HIV"/"natural"
+const char *marital(IPt idv); // "single"/"married"/"divorced"/"looking"
+int numChildren(IPt idv);
+const char *mom(IPt idv); // "dead"/"alive"
+const char *dad(IPt idv); // "dead"/"alive"
 
-string HIV(IPt idv); // bool
-string HIV_date(IPt idv); // in days
-string ART(IPt idv); // bool
-string ART_date(IPt idv); // in days
-string CD4(IPt idv, double t, double m_30);
-string ART_baseline_CD4(IPt idv, double m_30);
+const char *causeDeath(DeathCause cause_death); // "HIV"/"natural"
 
-string TBStatus(IPt idv, int t);
\ No newline at end of file
+const char *HIV(IPt idv); // bool
+int HIV_date(IPt idv); // in days
+const char *ART(IPt idv); // bool
+int ART_date(IPt idv); // in days
+double CD4(IPt idv, double t, double m_30);
+double ART_baseline_CD4(IPt idv, double m_30);
+
+const char *TBStatus(IPt idv, int t);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <JSONImport.h>
+
+using std::string;
+
+// Native replacement for params/gen_runsheets.R: generates the parameter
+// sets of a sweep in memory, from a range file, rather than writing them
+// out as runsheets through R and csvjson.
+//
+// A sweep varies the 'parameter-1' of named runsheet rows, just as
+// gen_runsheets.R does. Its parameter sets are stored row-major: set 'k'
+// is values[k*n .. k*n + n-1], in the order of the ranges.
+namespace Sweep {
+
+enum class Design { Grid, LHS, Sobol };
+
+struct Range {
+  string name;  // 'short-name' of the runsheet row
+  double lower;
+  double upper;
+  double step;  // Only used by Design::Grid
+};
+
+// Reads a range file: a CSV with a header naming its columns. Both the
+// rangefile (name,lower,upper,step) and priorfile (name,min,max) formats
+// of gen_runsheets.R are accepted. Exits if the file is malformed.
+std::vector<Range> ReadRanges(const char *file);
+
+// 'Grid' crosses seq(lower, upper, step) of every range, the first range
+// varying fastest, as gen_runsheets.R -r does; 'n' is ignored. 'LHS' and
+// 'Sobol' draw 'n' points from the box [lower, upper]^d. Sobol points come
+// from the Joe-Kuo direction numbers, randomized by a digital shift drawn
+// from 'seed', and support up to MaxSobolDimensions ranges. Exits if the
+// design can't be generated.
+std::vector<double> Generate(Design design,
+                             const std::vector<Range>& ranges,
+                             std::uint32_t n,
+                             std::uint64_t seed);
+
+const int MaxSobolDimensions = 21;
+
+// Reads a runsheet CSV, such as params/runsheet_prototype.csv, into the
+// same JSON that csvjson would have produced from it, so that a runsheet
+// need not be converted before it is used. Throws std::runtime_error if
+// it can't be read.
+json ReadRunsheetCSV(const char *file);
+
+// Sets 'parameter-1' of each row of 'sheet' named by 'ranges' to the
+// corresponding value of parameter set 'k'. Throws std::runtime_error if
+// 'sheet' lacks one of them, or there is no set 'k'.
+void Apply(json& sheet,
+           const std::vector<Range>& ranges,
+           const std::vector<double>& values,
+           std::uint32_t k);
+
+} // namespace Sweep
@@ -8,19 +8,19 @@
 #include <Uniform.h>
 #include <EventQueue.h>
 #include <Param.h>
-#include <DataFrame.h>
 #include <IncidenceTimeSeries.h>
 
 #include "MasterData.h"
 #include "IndividualTypes.h"
 #include "HouseholdTypes.h"
 #include "TBTypes.h"
+#include "AgentRegistry.h"
+#include "Names.h"
 
 using namespace SimulationLib;
 
 using std::function;
 using std::string;
-using Params = std::map<std::string, Param>;
 using EQ = EventQueue<double, bool>;
 
 class TB
@@ -39,7 +39,7 @@ class TB
         TBHandlers initHandlers,
         TBQueryHandlers initQueryHandlers,
 
-        string name,
+        NameID name,
         Sex sex,
 
         double risk_window = 3*30, // unit: [days]
@@ -55,8 +55,6 @@ class TB
       name(name),
       sex(sex),
 
-      GetLifetimePtr(initQueryHandlers.Lifetime),
-
       DeathHandler(initHandlers.death),
 
       data(initData),
@@ -64,6 +62,10 @@ class TB
       rng(initCtx.rng),
       fileData(initCtx.fileData),
       params(initCtx.params),
+      households(initCtx.households),
+      agents(initCtx.agents),
+      handle(initCtx.agents.Acquire()),
+      household_id(-1),
 
       risk_window(risk_window),
       tb_status(tb_status),
@@ -75,18 +77,19 @@ class TB
         data.tbSusceptible.Record(initCtx.current_time, +1);
       }
 
+    // Invalidates every event this TB still has in the queue
+    ~TB() { agents.Release(handle); }
+
+    TB(const TB&) = delete;
+    TB& operator=(const TB&) = delete;
+
     TBStatus GetTBStatus(Time);
     bool PreviouslyTreated(void);
 
-    void SetHouseholdCallbacks(
-        function<ContactTraceResult(const Time&, Param&, Param&, RNG&)> contactTrace,
-        function<void(Time)> progression, 
-        function<void(Time)> recovery,
-        function<double(void)> householdPrevalence,
-        function<double(TBStatus)> contactHouseholdPrevalence,
-        function<int(int, int)> householdTBCases,
-        function<int(int, int)> householdSize);
-    void ResetHouseholdCallbacks(void);
+    // Called by Household when the individual joins or leaves it. All
+    // household queries go through 'households' using this ID.
+    void SetHousehold(long hid);
+    void ResetHousehold(void);
 
     void InitialEvents(void);
 
@@ -122,9 +125,9 @@ class TB
     // 
     // When scheduling an infection, the only StrainType
     // supported right now is 'Unspecified'.
-    void InfectionRiskEvaluate(Time, int local_risk_window = 0, shared_p<TB> = {});
+    void InfectionRiskEvaluate(Time, int local_risk_window = 0);
     void InfectionRiskEvaluate_initial(int local_risk_window = 0);
-    bool InfectionRiskEvaluate_impl(Time, int local_risk_window = 0, shared_p<TB> = {});
+    bool InfectionRiskEvaluate_impl(Time, int local_risk_window = 0);
 
     // Marks an individual as latently infected. May transition
     // to infectous TB through reactivation.
@@ -163,6 +166,21 @@ class TB
     // Helper functions
     //////////////////////////////////////////////////////////////////////////
 
+    // Every TB event goes through here. The event carries this TB's handle
+    // rather than an owning pointer, and is dropped without being invoked
+    // if the individual has been destroyed by the time it comes up. Note
+    // that 'this' must not be touched before the handle is checked.
+    template <typename F>
+    void Schedule(Time t, F&& f) {
+      eq.QuickSchedule(t, [&agents = agents, h = handle, f = std::forward<F>(f)]
+                          (auto ts, auto scheduler) mutable -> bool {
+        if (!agents.Valid(h))
+          return true;
+
+        return f(ts, scheduler);
+      });
+    }
+
     void EnterAdulthood(void);
 
     HIVType GetHIVType(Time t);
@@ -190,12 +208,18 @@ class TB
     bool treatment_experienced = false;
 
     // All of these are from the constructor
-    string name;
+    NameID name;
     Sex sex;
     EQ& eq;
     RNG& rng;
-    map<string, DataFrameFile>& fileData;
-    Params& params;
+    const FrameTable& fileData;
+    ParamTable& params;
+    HouseholdService& households;
+    AgentRegistry& agents;
+
+    const AgentHandle handle;
+
+    long household_id; // -1 when not a member of any household
 
     int init_time;
 
@@ -211,19 +235,10 @@ class TB
     function<HIVStatus(void)> GetHIVStatus;
     function<bool(void)> ARTStatus;
     function<double(Time)> GlobalTBPrevalence;
-    function<double(void)> HouseholdTBPrevalence;
-    function<double(TBStatus)> ContactHouseholdTBPrevalence;
-    function<int(int maxage, int t)> HouseholdTBCases;
-    function<int(int maxage, int t)> HouseholdSize;
-
-    function<shared_p<TB>(void)> GetLifetimePtr;
 
     //////////////////////////////////////////////////////////////////////////
     // Event handler functions
     //////////////////////////////////////////////////////////////////////////
 
     function<void(Time)> DeathHandler;   
-    function<void(Time)> ProgressionHandler;
-    function<ContactTraceResult(const Time&, Param&, Param&, RNG&)>  ContactTraceHandler;
-    function<void(Time)> RecoveryHandler;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <map>
 #include <string>
 #include <ctime>
@@ -18,10 +19,11 @@
 #include <EventQueue.h>
 
 #include <Param.h>
-#include <DataFrame.h>
 #include <JSONImport.h>
 
 #include "MasterData.h"
+#include "ParamTable.h"
+#include "FrameTable.h"
 
 #include "Individual.h"
 #include "IndividualTypes.h"
@@ -29,10 +31,12 @@
 
 #include "Household.h"
 #include "HouseholdGen.h"
+#include "World.h"
 
 #include "Pointers.h"
 
 #include "utils/termcolor.h"
+#include "utils/csv.h"
 
 using std::map;
 using std::vector;
@@ -42,21 +46,43 @@ using namespace StatisticalDistributions;
 using namespace SimulationLib;
 using namespace SimulationLib::JSONImport;
 
+enum class SurveyKind { Population, Household, Death };
+
+// Takes a block of whole rows of one of a trajectory's surveys, moving
+// them out of the trajectory
+using SurveySink = std::function<void(SurveyKind, string&&)>;
+
+// Everything a finished trajectory exports. TBABM::TakeResults() moves it
+// out, so the trajectory and its population can be freed before the
+// results are written.
+struct TrajectoryResult {
+  std::uint_fast64_t seed;
+  MasterData data;
+
+  // Empty if they were streamed (see TBABM::StreamSurveys)
+  string populationSurvey;
+  string householdSurvey;
+  string deathSurvey;
+
+  bool WriteSurveys(shared_p<ofstream> ps, 
+      shared_p<ofstream> hs, 
+      shared_p<ofstream> ds) const;
+};
+
 class TBABM {
   public:
-    using Params = map<string, Param>;
     using Constants = map<string, long double>;
 
     using EQ = EventQueue<double, bool>;
     using EventFunc = EQ::EventFunc;
     using SchedulerT = EQ::SchedulerT;
 
-    TBABM(Params params_, 
+    TBABM(const World& world,
         std::map<string, long double> constants_,
-        const char *householdsFile, 
         const std::uint_fast64_t _seed) : 
 
-      params(params_),
+      fileData(world.frames),
+      params(world.params),
       constants(constants_),
 
       data(constants_["tMax"],
@@ -65,33 +91,35 @@ class TBABM {
 
       seed(_seed),
       rng(_seed),
-      householdGen(householdsFile, 
+      householdService(households),
+      householdGen(world.families, 
           params,
           fileData,
           eq,
           data,
+          householdService,
+          agents,
           CreateIndividualHandlers([this] (weak_ptr<Individual> i, int t, DeathCause dc) -> void { return Schedule(t, Death(i, dc)); },
             [this] (int t) -> double { return (double)data.tbInfectious(t)/(double)data.populationSize(t); }))
       {
-        // Associate DataFrameFile's with parameters which map to a file, rather
-        // than directly to a distribution
-        for (auto it = params.begin(); it != params.end(); it++)
-          if (it->second.getType() == SimulationLib::Type::file_type) {
-            auto j = JSONImport::fileToJSON(it->second.getFileName());
-            fileData[it->first] = DataFrameFile{j};
-          }
-
         printf("Seed: %llu\n", seed);
       };
 
       bool Run(void);
 
-      MasterData
-        GetData(void);
+      // From now on, hands survey rows to 'sink' as they are made, in blocks
+      // of at least 'block' bytes (and whatever is left when Run() returns),
+      // rather than keeping them all for TakeResults(). 'sink' is called on
+      // the thread running the trajectory.
+      void StreamSurveys(SurveySink sink, std::size_t block);
 
-      bool WriteSurveys(shared_p<ofstream> ps, 
-          shared_p<ofstream> hs, 
-          shared_p<ofstream> ds);
+      // Not a copy: see TakeResults() for the data of a finished run
+      const MasterData&
+        GetData(void) const;
+
+      // Leaves this TBABM's data and surveys empty
+      TrajectoryResult
+        TakeResults(void);
 
   private:
 
@@ -155,7 +183,19 @@ class TBABM {
       ////////////////////////////////////////////////////////
       /// Demographic Utilities
       ////////////////////////////////////////////////////////
-      void InitialEvents(weak_p<Individual> idv, double t, double dt);
+      // The draws Algorithm S2 makes for an individual of the initial
+      // population, made ahead of scheduling anything, from 'rng'
+      struct InitialDraws {
+        double timeToDeath;   // Unit: years
+        double timeToLooking; // Unit: years
+        bool   pregnant;
+        double yearsToBirth;  // If pregnant
+        bool   hivPositive;
+      };
+
+      InitialDraws DrawInitialEvents(Individual& idv, double t, RNG& rng);
+      void InitialEvents(shared_p<Individual> idv, double t, double dt,
+                         const InitialDraws& draws);
 
       void PurgeReferencesToIndividual(weak_p<Individual> host,
           weak_p<Individual> idv);
@@ -164,9 +204,14 @@ class TBABM {
 
       void ChangeHousehold(weak_p<Individual> idv, int time, int newHID, HouseholdPosition newRole);
 
+      // Adds 'idv' to the population, and gives it the next ID
+      void AddToPopulation(shared_p<Individual> idv);
+
       void SurveyDeath(shared_p<Individual> idv, int t, DeathCause deathCause);
 
-      Names name_gen;
+      // Adds 'rows' to a survey. While streaming, hands the survey to the
+      // sink once it has a block (or, with 'flush', anything).
+      void SurveyRows(SurveyKind survey, const string& rows, bool flush = false);
 
       ////////////////////////////////////////////////////////
       /// HIV Events
@@ -196,13 +241,17 @@ class TBABM {
       /// Data
       ////////////////////////////////////////////////////////
 
-      map<string, DataFrameFile> fileData;
-      Params params;
+      const FrameTable& fileData;
+      ParamTable params;
 
       MasterData data;
 
+      // Declared ahead of 'population' so that it outlives every agent
+      AgentRegistry agents;
+
       vector<shared_p<Individual>> population;
-      map<long, shared_p<Household>> households;
+      HouseholdTable households;
+      HouseholdService householdService;
 
       vector<weak_p<Individual>> maleSeeking;
       vector<weak_p<Individual>> femaleSeeking;
@@ -214,6 +263,7 @@ class TBABM {
       HouseholdGen householdGen;
 
       long nHouseholds = 0;
+      long nIndividuals = 0;
 
       RNG rng;
       std::uint_fast64_t seed;
@@ -221,4 +271,8 @@ class TBABM {
       string populationSurvey;
       string householdSurvey;
       string deathSurvey;
+      CSVRow surveyRow; // Each row is formatted in it, then added to its survey
+
+      SurveySink surveySink;
+      std::size_t surveyBlock {0};
 };
@@ -27,6 +27,9 @@ enum class RecoveryType {Natural, Treatment};
 
 enum class CTraceType {None, Vul, IVul, Prob};
 
+// The kind of contact tracing every trajectory in the process does
+extern CTraceType trace_kind;
+
 typedef struct TBHistoryItem {
   int t_infection;
   Source source;
@@ -52,7 +55,6 @@ typedef struct TBQueryHandlers {
   function<HIVStatus(void)> GetHIVStatus;
   function<bool(void)> ART;
   function<double(Time)> GlobalTBPrevalence;
-  function<shared_p<TB>(void)> Lifetime;
 } TBQueryHandlers;
 
 TBQueryHandlers CreateTBQueryHandlers(
@@ -61,8 +63,7 @@ TBQueryHandlers CreateTBQueryHandlers(
   function<double(Time)> CD4Count,
   function<HIVStatus(void)> HIVStatus,
   function<bool(void)> ART,
-  function<double(Time)> GlobalTBPrevalence,
-  function<shared_p<TB>(void)> Lifetime
+  function<double(Time)> GlobalTBPrevalence
 );
 
 typedef IndividualSimContext TBSimContext; // For right now these are the same
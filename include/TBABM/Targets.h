@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "MasterData.h"
+
+using std::string;
+
+// A statistic of a trajectory that --adaptive watches: the mean, over a
+// range of years, of one of the time series of OutputNames.inc, sampled
+// at mid-year. Dividing by a second series gives a proportion, e.g.
+// 'hivPositive/populationSize' for HIV prevalence.
+struct Target {
+  string spec;
+  string numerator;
+  string denominator; // Empty if none
+  int from;           // Calendar years, inclusive
+  int to;
+};
+
+// Parses a comma-separated list of 'name[/name][@from[-to]]'. Without
+// '@', a target covers every year of the run. Exits if a name isn't an
+// exported time series, or a year is outside the run.
+std::vector<Target> ParseTargets(const string& arg, int startYear, int years);
+
+// The value of 'target' in the trajectory that recorded 'data'
+double Evaluate(const Target& target, MasterData& data, int startYear, int periodLength);
+
+// Running mean and variance of each target over a job's trajectories,
+// with Welford's update
+class TargetStats {
+  public:
+    explicit TargetStats(std::size_t n_targets) :
+      n(0), mean(n_targets, 0), m2(n_targets, 0) {};
+
+    void Add(const std::vector<double>& values);
+
+    int Count(void) const { return n; }
+    double Mean(std::size_t k) const { return mean[k]; }
+
+    // Monte Carlo standard error of the mean of target 'k'
+    double SE(std::size_t k) const;
+
+    // True once there are at least two trajectories, and the standard
+    // error of every target is at most 'tolerance': absolute, or a
+    // fraction of the magnitude of the target's mean if 'relative'
+    bool Converged(double tolerance, bool relative) const;
+
+  private:
+    int n;
+    std::vector<double> mean;
+    std::vector<double> m2;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+
+#include "ParamTable.h"
+#include "FrameTable.h"
+#include "HouseholdTemplates.h"
+
+// Everything a trajectory reads but never writes: built once per process,
+// and shared by const reference by every trajectory on the ThreadPool. The
+// name table needs no place here; it is a process-wide static (Names.h).
+//
+// Sampling a Param is not const, so each TBABM takes its own copy of
+// 'params' (an array of ParamID::Count Param's) rather than sharing it.
+// Compiled frames draw through distributions built on the stack, and can
+// be shared.
+//
+// Frames and household templates don't depend on the rest of a runsheet,
+// so a batch of runsheets can share them between Worlds, too.
+class World {
+  public:
+    World(const ParamTable& params, const char *householdsFile) :
+      World(params,
+            std::make_shared<const FrameTable>(params.Files()),
+            std::make_shared<const HouseholdTemplates>(householdsFile)) {};
+
+    World(const ParamTable& params,
+          std::shared_ptr<const FrameTable> frames,
+          std::shared_ptr<const HouseholdTemplates> families) :
+      params(params),
+      frames(*frames),
+      families(*families),
+      frames_(frames),
+      families_(families) {};
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    const ParamTable params;
+    const FrameTable& frames;
+    const HouseholdTemplates& families;
+
+    std::shared_ptr<const FrameTable> SharedFrames(void) const { return frames_; }
+    std::shared_ptr<const HouseholdTemplates> SharedFamilies(void) const { return families_; }
+
+  private:
+    std::shared_ptr<const FrameTable> frames_;
+    std::shared_ptr<const HouseholdTemplates> families_;
+};
@@ -0,0 +1,125 @@
+#ifndef CSV_H
+#define CSV_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// The fields of a line of CSV, as TBABM and SimulationLib write them.
+// Fields may be quoted, with "" standing for a quote, but a row is one
+// line.
+inline std::vector<std::string> SplitCSV(const std::string& line)
+{
+  std::vector<std::string> fields {};
+  std::string field {};
+  bool quoted {false};
+
+  for (std::size_t k = 0; k < line.size(); k++) {
+    char c = line[k];
+
+    if (quoted && c == '"' && k + 1 < line.size() && line[k+1] == '"') {
+      field += '"';
+      k++;
+    }
+    else if (c == '"')
+      quoted = !quoted;
+    else if (c == ',' && !quoted) {
+      fields.push_back(field);
+      field.clear();
+    }
+    else if (c != '\r' || quoted)
+      field += c;
+  }
+
+  fields.push_back(field);
+
+  return fields;
+}
+
+// Builds a line of CSV, a field at a time, in a buffer that is kept from
+// one line to the next, so that once it has grown to the longest line,
+// no field allocates. Numbers are written straight into it, as
+// std::to_chars would (C++14 has no to_chars); a double is written as
+// std::to_string writes it, "%f", so that the text is what it always was.
+//
+//   row.Clear();
+//   row << seed << t << "male";
+//   row.End(); // "12,365.000000,male\n"
+class CSVRow {
+  public:
+    CSVRow(void) { buf.reserve(256); }
+
+    // Starts a new line, keeping the buffer
+    void Clear(void) { buf.clear(); first = true; }
+
+    // Ends the line
+    void End(void) { buf += '\n'; }
+
+    const std::string& Text(void) const { return buf; }
+
+    CSVRow& operator<<(bool b) { return *this << (b ? 1 : 0); }
+
+    // Integers
+    template <typename T,
+              typename = typename std::enable_if<std::is_integral<T>::value>::type>
+    CSVRow& operator<<(T v) {
+      separate();
+
+      char digits[24];
+      char *end = digits + sizeof(digits);
+      char *p   = end;
+
+      // Negated as unsigned, so that the least value has a magnitude too
+      using U = typename std::make_unsigned<T>::type;
+      U u = v < 0 ? U(0) - static_cast<U>(v) : static_cast<U>(v);
+
+      do {
+        *--p = '0' + u % 10;
+        u /= 10;
+      } while (u);
+
+      if (v < 0)
+        *--p = '-';
+
+      buf.append(p, end - p);
+      return *this;
+    }
+
+    CSVRow& operator<<(double v) {
+      // A whole number, such as a time, is written without printf, with
+      // the six zeros "%f" would give it
+      if (std::abs(v) < 1e15 && v == std::floor(v) && !(v == 0 && std::signbit(v))) {
+        *this << static_cast<long long>(v);
+        buf.append(".000000", 7);
+        return *this;
+      }
+
+      separate();
+
+      char text[512];
+      int n = snprintf(text, sizeof(text), "%f", v);
+      buf.append(text, n > 0 ? std::min<std::size_t>(n, sizeof(text) - 1) : 0);
+      return *this;
+    }
+
+    CSVRow& operator<<(const char *s) {
+      separate();
+      buf += s;
+      return *this;
+    }
+
+  private:
+    void separate(void) {
+      if (!first)
+        buf += ',';
+      first = false;
+    }
+
+    std::string buf;
+    bool first {true};
+};
+
+#endif // CSV_H
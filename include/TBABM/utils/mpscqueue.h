@@ -0,0 +1,186 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// A bounded, lock-free queue for many producers and a single consumer,
+// after Dmitry Vyukov's bounded MPMC queue. Each cell carries a sequence
+// number which tells a producer whether the cell is free, and the consumer
+// whether it is full, so neither side takes a lock to move an element.
+//
+// Push and Pop block, without spinning or polling, while the queue is full
+// or empty: they sleep on a condition variable until a Pop or Push makes
+// room or an element. A full queue is the back-pressure: producers can run
+// at most 'capacity' elements ahead of the consumer. While nothing sleeps,
+// neither side touches the mutex.
+template <class T>
+class MPSCQueue {
+  public:
+    // 'capacity' is rounded up to a power of two
+    explicit MPSCQueue(size_t capacity);
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    // Moves from 'v' only if they succeed
+    bool TryPush(T& v);
+    bool TryPop(T& v);
+
+    void Push(T v);
+    void Pop(T& v);
+
+  private:
+    struct Cell {
+      std::atomic<size_t> sequence;
+      T value;
+    };
+
+    bool full(void) const;
+    bool empty(void) const;
+
+    template <class Ready>
+    void Wait(Ready ready);
+    void Wake(void);
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> head; // Next cell to push; producers
+    alignas(64) size_t tail;              // Next cell to pop; consumer only
+
+    std::atomic<int> waiters {0};
+    std::mutex wait_mutex;
+    std::condition_variable condition;
+};
+
+template <class T>
+MPSCQueue<T>::MPSCQueue(size_t capacity)
+  : head(0), tail(0)
+{
+  size_t size = 2;
+  while (size < capacity)
+    size <<= 1;
+
+  cells.reset(new Cell[size]);
+  mask = size - 1;
+
+  for (size_t i = 0; i < size; ++i)
+    cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template <class T>
+bool MPSCQueue<T>::TryPush(T& v)
+{
+  Cell *cell;
+  size_t pos = head.load(std::memory_order_relaxed);
+
+  for (;;) {
+    cell = &cells[pos & mask];
+    size_t seq = cell->sequence.load(std::memory_order_acquire);
+    auto dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+
+    if (dif == 0) {
+      if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    } else if (dif < 0)
+      return false; // Full
+    else
+      pos = head.load(std::memory_order_relaxed);
+  }
+
+  cell->value = std::move(v);
+  cell->sequence.store(pos + 1, std::memory_order_release);
+
+  return true;
+}
+
+template <class T>
+bool MPSCQueue<T>::TryPop(T& v)
+{
+  Cell *cell = &cells[tail & mask];
+  size_t seq = cell->sequence.load(std::memory_order_acquire);
+
+  if (static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(tail + 1) < 0)
+    return false; // Empty
+
+  v = std::move(cell->value);
+  cell->sequence.store(tail + mask + 1, std::memory_order_release);
+  tail++;
+
+  return true;
+}
+
+// Whether the next cell to push to, or pop from, isn't ready yet. Either
+// may be stale by the time it's acted on; TryPush and TryPop decide.
+template <class T>
+bool MPSCQueue<T>::full(void) const
+{
+  size_t pos = head.load(std::memory_order_relaxed);
+  size_t seq = cells[pos & mask].sequence.load(std::memory_order_acquire);
+
+  return static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos) < 0;
+}
+
+template <class T>
+bool MPSCQueue<T>::empty(void) const
+{
+  size_t seq = cells[tail & mask].sequence.load(std::memory_order_acquire);
+
+  return static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(tail + 1) < 0;
+}
+
+// Sleeps until 'ready'. A waiter is counted before it tests 'ready', and
+// Wake reads the count after the push or pop it follows, with a full fence
+// on each side between the two: so either the waiter sees that push or
+// pop, or Wake sees the waiter, and notifies it under the mutex, which it
+// can't do while the waiter is between its test and its sleep.
+template <class T>
+template <class Ready>
+void MPSCQueue<T>::Wait(Ready ready)
+{
+  std::unique_lock<std::mutex> lock(wait_mutex);
+
+  waiters.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  condition.wait(lock, ready);
+
+  waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <class T>
+void MPSCQueue<T>::Wake(void)
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (waiters.load(std::memory_order_relaxed) == 0)
+    return;
+
+  std::lock_guard<std::mutex> lock(wait_mutex);
+  condition.notify_all();
+}
+
+template <class T>
+void MPSCQueue<T>::Push(T v)
+{
+  while (!TryPush(v))
+    Wait([this] { return !full(); });
+
+  Wake();
+}
+
+template <class T>
+void MPSCQueue<T>::Pop(T& v)
+{
+  while (!TryPop(v))
+    Wait([this] { return !empty(); });
+
+  Wake();
+}
+
+#endif
@@ -0,0 +1,293 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// A drop-in alternative to ThreadPool for batches of long, uneven tasks
+// such as trajectories. Each task carries an expected cost (any unit, so
+// long as it's consistent within a batch).
+//
+// Every worker owns a deque, kept in order of decreasing cost. A new task
+// goes to the worker with the least queued cost. A free worker runs the
+// front of its own deque, locking only that deque. Only once its own deque
+// is empty does it steal, from the front of the deque with the most cost
+// queued. Each worker therefore starts its longest tasks first, and no
+// core idles while any task is waiting.
+//
+// Since tasks are spread by queued cost, the fronts of the deques are
+// close in cost, and the order is longest-first across the pool up to
+// that spread.
+//
+// Ordering can only be longest-first among tasks that are queued, so a
+// batch should be enqueued between Hold() and Release(): otherwise the
+// first few tasks start as soon as they arrive, however short they are.
+//
+// With 'pin' set, worker 'i' is bound to CPU 'first_cpu + i' of those
+// the process may run on (its sched_getaffinity set, which a cgroup or
+// Slurm allocation restricts), modulo their number. Processes sharing a
+// node each pass a different 'first_cpu', so that they don't pin onto the
+// same CPUs. A worker that can't be pinned is reported, and runs unpinned.
+// Memory is first touched by the thread that allocates it, so a pinned
+// trajectory also keeps its memory on that CPU's NUMA node.
+class WorkStealingPool {
+  public:
+    WorkStealingPool(size_t threads, bool pin = false, size_t first_cpu = 0);
+
+    template<class F, class... Args>
+      auto enqueue(double cost, F&& f, Args&&... args)
+      -> std::future<typename std::result_of<F(Args...)>::type>;
+
+    // While held, workers start no new tasks
+    void Hold(void);
+    void Release(void);
+
+    ~WorkStealingPool();
+
+  private:
+    struct Task {
+      double cost;
+      std::function<void()> run;
+    };
+
+    struct Queue {
+      std::mutex mutex;
+      std::deque<Task> tasks; // Decreasing cost
+      double queued_cost {0};
+    };
+
+    bool TryPop(size_t self, Task& task);
+    void Work(size_t self);
+
+    std::vector< std::unique_ptr<Queue> > queues;
+    std::vector< std::thread > workers;
+
+    // Workers with nothing to run or steal sleep on 'condition'
+    std::mutex sleep_mutex;
+    std::condition_variable condition;
+    std::atomic<size_t> pending;
+    bool held;
+    bool stop;
+};
+
+inline WorkStealingPool::WorkStealingPool(size_t threads, bool pin, size_t first_cpu)
+  : pending(0), held(false), stop(false)
+{
+  if (threads == 0)
+    threads = 1;
+
+  for (size_t i = 0; i < threads; ++i)
+    queues.emplace_back(new Queue);
+
+#ifdef __linux__
+  // The CPUs this process may run on, in order
+  std::vector<int> allowed {};
+
+  if (pin) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        if (CPU_ISSET(cpu, &set))
+          allowed.push_back(cpu);
+    } else
+      printf("Warning: could not read the CPUs allowed (%s); not pinning\n",
+             strerror(errno));
+  }
+#else
+  (void)pin;
+  (void)first_cpu;
+#endif
+
+  for (size_t i = 0; i < threads; ++i) {
+    workers.emplace_back([this, i] { Work(i); });
+
+#ifdef __linux__
+    if (!allowed.empty()) {
+      int cpu = allowed[(first_cpu + i) % allowed.size()];
+
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+
+      // Returns the error, rather than setting errno
+      int error = pthread_setaffinity_np(workers.back().native_handle(), sizeof(set), &set);
+
+      if (error != 0)
+        printf("Warning: could not pin worker %lu to CPU %d: %s\n", i, cpu, strerror(error));
+    }
+#endif
+  }
+}
+
+// Takes the front of worker 'self''s own deque, or, if that is empty,
+// steals the front of the deque with the most cost queued. Only a worker
+// with nothing of its own looks at the other deques.
+inline bool WorkStealingPool::TryPop(size_t self, Task& task)
+{
+  {
+    auto& own = *queues[self];
+    std::unique_lock<std::mutex> lock(own.mutex);
+
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.front());
+      own.tasks.pop_front();
+      own.queued_cost -= task.cost;
+
+      return true;
+    }
+  }
+
+  for (;;) {
+    size_t victim = queues.size();
+    double most   = 0;
+
+    for (size_t j = 1; j < queues.size(); ++j) {
+      size_t i = (self + j) % queues.size();
+
+      std::unique_lock<std::mutex> lock(queues[i]->mutex);
+      if (!queues[i]->tasks.empty() && \
+          (victim == queues.size() || queues[i]->queued_cost > most)) {
+        victim = i;
+        most   = queues[i]->queued_cost;
+      }
+    }
+
+    if (victim == queues.size())
+      return false;
+
+    auto& q = *queues[victim];
+    std::unique_lock<std::mutex> lock(q.mutex);
+
+    // Another worker may have taken it since; look again
+    if (q.tasks.empty())
+      continue;
+
+    task = std::move(q.tasks.front());
+    q.tasks.pop_front();
+    q.queued_cost -= task.cost;
+
+    return true;
+  }
+}
+
+inline void WorkStealingPool::Work(size_t self)
+{
+  for (;;) {
+    Task task;
+
+    {
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      condition.wait(lock, [this] { return stop || !held; });
+    }
+
+    if (TryPop(self, task)) {
+      pending--;
+      task.run();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    condition.wait(lock, [this] { return stop || (!held && pending > 0); });
+
+    if (stop && pending == 0)
+      return;
+  }
+}
+
+template<class F, class... Args>
+auto WorkStealingPool::enqueue(double cost, F&& f, Args&&... args)
+  -> std::future<typename std::result_of<F(Args...)>::type>
+{
+  using return_type = typename std::result_of<F(Args...)>::type;
+
+  auto task = std::make_shared< std::packaged_task<return_type()> >(
+      std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+      );
+
+  std::future<return_type> res = task->get_future();
+
+  {
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    if (stop)
+      throw std::runtime_error("enqueue on stopped WorkStealingPool");
+  }
+
+  // The least loaded worker gets the task
+  size_t target = 0;
+  double least  = 0;
+
+  for (size_t i = 0; i < queues.size(); ++i) {
+    std::unique_lock<std::mutex> lock(queues[i]->mutex);
+    if (i == 0 || queues[i]->queued_cost < least) {
+      target = i;
+      least  = queues[i]->queued_cost;
+    }
+  }
+
+  {
+    auto& q = *queues[target];
+    std::unique_lock<std::mutex> lock(q.mutex);
+
+    auto it = q.tasks.begin();
+    while (it != q.tasks.end() && it->cost >= cost)
+      ++it;
+
+    q.tasks.insert(it, Task{cost, [task] () { (*task)(); }});
+    q.queued_cost += cost;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    pending++;
+  }
+  condition.notify_all();
+
+  return res;
+}
+
+inline void WorkStealingPool::Hold(void)
+{
+  std::unique_lock<std::mutex> lock(sleep_mutex);
+  held = true;
+}
+
+inline void WorkStealingPool::Release(void)
+{
+  {
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    held = false;
+  }
+  condition.notify_all();
+}
+
+inline WorkStealingPool::~WorkStealingPool()
+{
+  {
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    stop = true;
+    held = false;
+  }
+  condition.notify_all();
+  for (std::thread &worker : workers)
+    worker.join();
+}
+
+#endif
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <random>
+#include <vector>
+
+#include "../include/TBABM/utils/threadpool.h"
+#include "../include/TBABM/utils/workstealing.h"
+
+// Makespan of a batch of trajectory-like tasks on ThreadPool (FIFO) and
+// on WorkStealingPool (longest expected first). Task durations are
+// lognormal, so that a few are far longer than the rest, as trajectories
+// whose population blows up are. Each task sleeps for its duration,
+// standing in for a trajectory that keeps one core busy.
+//
+//   BenchPools [threads] [tasks] [mean-ms] [sigma] [seed]
+
+using Clock = std::chrono::steady_clock;
+
+double Run(const std::vector<double>& ms,
+           std::function<std::future<void>(double, std::function<void()>)> submit,
+           std::function<void()> release = [] {})
+{
+  auto start = Clock::now();
+
+  std::vector<std::future<void>> results;
+  for (auto d : ms)
+    results.emplace_back(submit(d, [d] {
+      std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long>(d * 1000)));
+    }));
+
+  release();
+
+  for (auto&& r : results)
+    r.get();
+
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+  size_t threads = argc > 1 ? atoi(argv[1]) : 8;
+  size_t n_tasks = argc > 2 ? atoi(argv[2]) : 64;
+  double mean    = argc > 3 ? atof(argv[3]) : 50;
+  double sigma   = argc > 4 ? atof(argv[4]) : 1;
+  unsigned seed  = argc > 5 ? atoi(argv[5]) : 1;
+
+  std::mt19937_64 rng(seed);
+  std::lognormal_distribution<double> duration(std::log(mean) - sigma*sigma/2, sigma);
+  std::lognormal_distribution<double> noise(0, 0.3);
+
+  std::vector<double> ms(n_tasks);
+  std::vector<double> estimate(n_tasks);
+
+  for (size_t i = 0; i < n_tasks; i++) {
+    ms[i] = duration(rng);
+    estimate[i] = ms[i] * noise(rng); // A prior timing, off by ~30%
+  }
+
+  double total   = 0;
+  for (auto d : ms)
+    total += d;
+
+  double bound = std::max(total / threads, *std::max_element(ms.begin(), ms.end()));
+
+  double fifo, ws_exact, ws_noisy;
+
+  {
+    ThreadPool pool(threads);
+    fifo = Run(ms, [&pool] (double, std::function<void()> f) { return pool.enqueue(f); });
+  }
+
+  {
+    WorkStealingPool pool(threads);
+    pool.Hold();
+    ws_exact = Run(ms, [&pool] (double d, std::function<void()> f) { return pool.enqueue(d, f); },
+                   [&pool] { pool.Release(); });
+  }
+
+  {
+    WorkStealingPool pool(threads);
+    size_t i = 0;
+    pool.Hold();
+    ws_noisy = Run(ms, [&pool, &estimate, &i] (double, std::function<void()> f) {
+      return pool.enqueue(estimate[i++], f);
+    }, [&pool] { pool.Release(); });
+  }
+
+  printf("threads=%lu tasks=%lu mean=%.0fms sigma=%.2f\n", threads, n_tasks, mean, sigma);
+  printf("lower bound                    %8.1f ms\n", bound);
+  printf("ThreadPool (FIFO)              %8.1f ms\n", fifo);
+  printf("WorkStealingPool (exact cost)  %8.1f ms\n", ws_exact);
+  printf("WorkStealingPool (noisy cost)  %8.1f ms\n", ws_noisy);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <JSONImport.h>
+
+#include "../include/TBABM/RunsheetBundle.h"
+
+using namespace SimulationLib::JSONImport;
+
+using std::string;
+using std::vector;
+
+// Packs a prototype runsheet and a table of runs into a runsheet bundle.
+// The table is the .csv written by params/gen_runsheets.R: a 'run.id'
+// column, then one column per swept parameter, named by its short-name and
+// holding its 'parameter-1' in each run. Run 'k' of the bundle (counting
+// from 0) is row 'k' of the table.
+int main(int argc, char **argv)
+{
+  if (argc != 4) {
+    printf("Usage:\n  BundleRunsheets <prototype.json> <runs.csv> <output>\n");
+    return EXIT_FAILURE;
+  }
+
+  auto prototype = fileToJSON(argv[1]);
+
+  std::ifstream table(argv[2]);
+  if (!table) {
+    printf("Error: could not open '%s'\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  string line;
+  vector<string> names;
+  vector<double> values;
+
+  // Column 'skip' is 'run.id', which only numbers the rows
+  int skip {-1};
+
+  std::getline(table, line);
+  {
+    std::stringstream header(line);
+    string name;
+
+    for (int i = 0; std::getline(header, name, ','); i++) {
+      if (name.size() > 1 && name.front() == '"' && name.back() == '"')
+        name = name.substr(1, name.size() - 2);
+
+      if (name == "run.id")
+        skip = i;
+      else
+        names.push_back(name);
+    }
+  }
+
+  int lines {1};
+
+  while (std::getline(table, line)) {
+    lines++;
+
+    if (line.empty())
+      continue;
+
+    std::stringstream row(line);
+    string cell;
+    std::size_t n {0};
+
+    for (int i = 0; std::getline(row, cell, ','); i++) {
+      if (i == skip)
+        continue;
+
+      char *end {nullptr};
+      double v = strtod(cell.c_str(), &end);
+
+      if (cell.empty() || *end != '\0') {
+        printf("Error: line %d of '%s' has a nonnumeric value\n", lines, argv[2]);
+        return EXIT_FAILURE;
+      }
+
+      values.push_back(v);
+      n++;
+    }
+
+    if (n != names.size()) {
+      printf("Error: line %d of '%s' has %lu values, expected %lu\n",
+             lines, argv[2], n, names.size());
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (!RunsheetBundle::Write(argv[3], prototype, names, values))
+    return EXIT_FAILURE;
+
+  printf("Wrote %lu runs of %lu parameters to '%s'\n",
+         names.empty() ? 0 : values.size() / names.size(), names.size(), argv[3]);
+
+  return EXIT_SUCCESS;
+}
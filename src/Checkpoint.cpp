@@ -0,0 +1,281 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+#include <dirent.h>
+#include <ftw.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/TBABM/Checkpoint.h"
+#include "../include/TBABM/MergeOutputs.h"
+#include "../include/TBABM/RunOutputs.h"
+
+namespace {
+
+int removeEntry(const char *path, const struct stat *, int, struct FTW *)
+{
+  return remove(path);
+}
+
+// Removes 'path' and, if it's a directory, everything under it
+void removeTree(const string& path)
+{
+  nftw(path.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+bool isDir(const string& path)
+{
+  struct stat buf;
+  return stat(path.c_str(), &buf) == 0 && S_ISDIR(buf.st_mode);
+}
+
+bool endsWith(const string& s, const string& suffix)
+{
+  return s.size() >= suffix.size() && \
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+Checkpoint::Checkpoint(const string& dir) : dir(dir)
+{
+  if (this->dir.empty() || this->dir.back() != '/')
+    this->dir += '/';
+
+  mkdir(this->dir.c_str(), S_IRWXU);
+
+  if (!isDir(this->dir)) {
+    printf("Error: could not create checkpoint directory '%s'\n", this->dir.c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  // A trajectory still in a temporary directory was being saved when the
+  // run was killed; it will be run again
+  DIR *jobs = opendir(this->dir.c_str());
+
+  while (auto job = readdir(jobs)) {
+    string name {job->d_name};
+
+    if (name == "." || name == ".." || !isDir(this->dir + name))
+      continue;
+
+    DIR *trajectories = opendir((this->dir + name).c_str());
+
+    while (auto t = trajectories ? readdir(trajectories) : nullptr)
+      if (endsWith(t->d_name, ".tmp"))
+        removeTree(this->dir + name + "/" + t->d_name);
+
+    if (trajectories)
+      closedir(trajectories);
+  }
+
+  closedir(jobs);
+
+  // Job IDs may have commas in them, so the row is split from the right
+  std::ifstream in(this->dir + "in-flight.csv");
+  string line;
+
+  std::getline(in, line);
+
+  while (std::getline(in, line)) {
+    auto seed_at = line.rfind(',');
+    auto i_at    = seed_at == string::npos || seed_at == 0 ? \
+                   string::npos : line.rfind(',', seed_at - 1);
+
+    if (i_at == string::npos)
+      continue;
+
+    interrupted[{line.substr(0, i_at), atoi(line.c_str() + i_at + 1)}] = \
+      strtoull(line.c_str() + seed_at + 1, nullptr, 10);
+  }
+
+  if (interrupted.size() > 0)
+    printf("Resuming from checkpoint '%s': %lu trajectories were in flight when "
+           "it was stopped, and are started first\n",
+           this->dir.c_str(), interrupted.size());
+}
+
+std::uint_fast64_t
+Checkpoint::Seed(std::uint_fast64_t seed, bool given)
+{
+  std::ifstream in(dir + "seed");
+  std::uint_fast64_t saved;
+
+  if (in >> saved) {
+    if (given && saved != seed) {
+      printf("Error: checkpoint '%s' is of seed %lu, not %lu; resume it with "
+             "the same -s, or without one\n",
+             dir.c_str(), static_cast<unsigned long>(saved),
+             static_cast<unsigned long>(seed));
+      exit(EXIT_FAILURE);
+    }
+
+    if (saved != seed)
+      printf("Resuming from checkpoint '%s', of seed %lu\n",
+             dir.c_str(), static_cast<unsigned long>(saved));
+
+    return saved;
+  }
+
+  std::ofstream out(dir + "seed");
+  out << seed << std::endl;
+
+  if (!out) {
+    printf("Error: could not write to checkpoint directory '%s'\n", dir.c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  return seed;
+}
+
+string
+Checkpoint::path(const string& job, int i) const
+{
+  return dir + job + "/" + std::to_string(i);
+}
+
+bool
+Checkpoint::Restore(const string& job, int i, std::vector<double>& values) const
+{
+  if (!isDir(path(job, i)))
+    return false;
+
+  std::ifstream in(path(job, i) + "/targets");
+  double v;
+
+  values.clear();
+  while (in >> v)
+    values.push_back(v);
+
+  return true;
+}
+
+bool
+Checkpoint::Interrupted(const string& job, int i) const
+{
+  return interrupted.count({job, i}) > 0;
+}
+
+void
+Checkpoint::Started(const string& job, int i, std::uint_fast64_t seed)
+{
+  auto it = interrupted.find({job, i});
+
+  if (it != interrupted.end() && it->second != seed)
+    printf("Warning: trajectory %d of job %s had seed %lu when it was interrupted, "
+           "and now has %lu; have the arguments changed?\n", i, job.c_str(),
+           static_cast<unsigned long>(it->second), static_cast<unsigned long>(seed));
+
+  std::lock_guard<std::mutex> lock(mutex);
+  in_flight[{job, i}] = seed;
+}
+
+bool
+Checkpoint::Save(const string& job, int i, std::shared_ptr<TrajectoryResult> t,
+                 const std::vector<double>& values)
+{
+  string tmp {path(job, i) + ".tmp"};
+  bool ok {true};
+
+  mkdir((dir + job).c_str(), S_IRWXU);
+  mkdir(tmp.c_str(), S_IRWXU);
+  mkdir((tmp + "/outputs").c_str(), S_IRWXU);
+
+  {
+    RunOutputs outputs(tmp + "/outputs/");
+    ok = outputs.Ok() && outputs.Add(std::move(t)) && outputs.Write();
+  }
+
+  std::ofstream targets(tmp + "/targets");
+  targets.precision(17);
+
+  for (auto v : values)
+    targets << v << '\n';
+
+  targets.close();
+
+  ok = ok && targets && rename(tmp.c_str(), path(job, i).c_str()) == 0;
+
+  if (!ok) {
+    printf("Error: could not save trajectory %d of job %s to checkpoint '%s'\n",
+           i, job.c_str(), dir.c_str());
+    removeTree(tmp);
+  }
+
+  Abandon(job, i);
+
+  return ok;
+}
+
+void
+Checkpoint::Abandon(const string& job, int i)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  in_flight.erase({job, i});
+}
+
+bool
+Checkpoint::Merge(const string& job, const string& prefix, int n)
+{
+  bool ok {true};
+
+  // Copied rather than moved: if this is interrupted, the checkpoint is
+  // still whole, and merging starts over
+  for (int i = 0; i < n; i++)
+    if (isDir(path(job, i)))
+      ok &= MergeOutputs(path(job, i) + "/outputs/", prefix, merged[prefix], false);
+
+  return ok;
+}
+
+void
+Checkpoint::Remove(void)
+{
+  removeTree(dir);
+}
+
+std::size_t
+Checkpoint::writeInFlight(void)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  std::ofstream out(dir + "in-flight.csv");
+
+  out << "job,trajectory,seed\n";
+
+  for (auto&& t : in_flight)
+    out << t.first.first << ',' << t.first.second << ',' << t.second << '\n';
+
+  return in_flight.size();
+}
+
+void
+Checkpoint::HandleSignals(void)
+{
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGTERM);
+  sigaddset(&signals, SIGINT);
+
+  // Threads inherit the mask, so only this one ever sees them
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  std::thread([this, signals] {
+    int sig;
+
+    if (sigwait(&signals, &sig) != 0)
+      return;
+
+    auto n = writeInFlight();
+
+    printf("Caught signal %d; %lu trajectories in flight will be run again "
+           "when restarted from checkpoint '%s'\n",
+           sig, n, dir.c_str());
+    fflush(stdout);
+
+    _exit(128 + sig);
+  }).detach();
+}
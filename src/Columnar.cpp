@@ -0,0 +1,531 @@
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <zlib.h>
+
+#include "../include/TBABM/Columnar.h"
+#include "../include/TBABM/utils/csv.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Columnar files are little-endian, and are written in host order"
+#endif
+
+namespace Columnar {
+
+namespace {
+
+const char magic[8] {'T', 'B', 'A', 'B', 'M', 'C', 'O', 'L'};
+const std::uint32_t version {1};
+
+const std::int64_t missingInt32 {std::numeric_limits<std::int32_t>::min()};
+const std::int64_t missingInt64 {std::numeric_limits<std::int64_t>::min()};
+
+const double maxExactDouble {9007199254740992.0}; // 2^53
+
+// Whether 's' is written as an integer
+bool integral(const char *s)
+{
+  if (*s == '-' || *s == '+')
+    s++;
+
+  return *s != '\0' && s[strspn(s, "0123456789")] == '\0';
+}
+
+// Reads 'field' as a value of 'type', into 'i' or 'd'. An empty field is
+// missing. The least value of each integer type is taken to mean missing,
+// so it can't be read as one.
+bool parse(const string& field, Type type, std::int64_t& i, double& d)
+{
+  const char *s = field.c_str();
+  char *end {nullptr};
+
+  if (field.empty()) {
+    i = type == Type::Int32 ? missingInt32 : missingInt64;
+    d = std::numeric_limits<double>::quiet_NaN();
+    return true;
+  }
+
+  switch (type) {
+    case Type::Int32:
+    case Type::Int64:
+      errno = 0;
+      i = strtoll(s, &end, 10);
+
+      if (end == s || *end != '\0' || errno == ERANGE)
+        return false;
+
+      return type == Type::Int64 ? i > missingInt64 : \
+             i > missingInt32 && i <= std::numeric_limits<std::int32_t>::max();
+
+    case Type::Double:
+      d = strtod(s, &end);
+
+      if (end == s || *end != '\0')
+        return false;
+
+      // An integer too large for Int64 is read exactly as a String
+      // instead, where a double would keep only 53 bits of it
+      return !(integral(s) && std::fabs(d) > maxExactDouble);
+
+    case Type::String:
+      return true;
+  }
+
+  return false;
+}
+
+string quote(const string& s)
+{
+  if (s.find_first_of(",\"\n") == string::npos)
+    return s;
+
+  string quoted {"\""};
+
+  for (char c : s)
+    quoted += c == '"' ? string("\"\"") : string(1, c);
+
+  return quoted + "\"";
+}
+
+} // namespace
+
+string
+Chunk::Text(const std::vector<Column>& schema, std::size_t col, std::size_t row) const
+{
+  switch (schema[col].type) {
+    case Type::Int32:
+    case Type::Int64: {
+      auto i = ints[col][row];
+      return i == (schema[col].type == Type::Int32 ? missingInt32 : missingInt64) ? \
+        "" : std::to_string(i);
+    }
+
+    case Type::Double: {
+      double d = doubles[col][row];
+
+      if (std::isnan(d))
+        return "";
+
+      // The shortest of these that reads back as the same double
+      char buf[32];
+      snprintf(buf, sizeof(buf), "%.15g", d);
+
+      if (strtod(buf, nullptr) != d)
+        snprintf(buf, sizeof(buf), "%.17g", d);
+
+      return buf;
+    }
+
+    case Type::String:
+      return quote(strings[col][row]);
+  }
+
+  return "";
+}
+
+Writer::Writer(const string& path, const std::vector<Column>& schema,
+               std::size_t chunk_rows) :
+  file(fopen(path.c_str(), "wb")),
+  schema(schema),
+  chunk_rows(chunk_rows > 0 ? chunk_rows : 1)
+{
+  chunk.ints.resize(schema.size());
+  chunk.doubles.resize(schema.size());
+  chunk.strings.resize(schema.size());
+
+  if (!file)
+    return;
+
+  std::uint32_t columns = schema.size();
+
+  put(magic, sizeof(magic));
+  put(&version, sizeof(version));
+  put(&columns, sizeof(columns));
+
+  for (auto&& column : schema) {
+    std::uint32_t length = column.name.size();
+
+    put(&length, sizeof(length));
+    put(column.name.data(), length);
+    put(&column.type, sizeof(column.type));
+  }
+}
+
+Writer::~Writer(void)
+{
+  if (file)
+    Close();
+}
+
+bool
+Writer::put(const void *data, std::size_t size)
+{
+  ok = ok && fwrite(data, 1, size, file) == size;
+  return ok;
+}
+
+bool
+Writer::Add(const std::vector<string>& fields)
+{
+  if (!Ok() || fields.size() != schema.size())
+    return false;
+
+  std::vector<std::int64_t> ints(schema.size());
+  std::vector<double> doubles(schema.size());
+
+  for (std::size_t c = 0; c < schema.size(); c++)
+    if (!parse(fields[c], schema[c].type, ints[c], doubles[c]))
+      return false;
+
+  for (std::size_t c = 0; c < schema.size(); c++)
+    switch (schema[c].type) {
+      case Type::Int32:
+      case Type::Int64:  chunk.ints[c].push_back(ints[c]);       break;
+      case Type::Double: chunk.doubles[c].push_back(doubles[c]); break;
+      case Type::String: chunk.strings[c].push_back(fields[c]);  break;
+    }
+
+  if (++chunk.rows == chunk_rows)
+    return flush();
+
+  return true;
+}
+
+bool
+Writer::flush(void)
+{
+  if (chunk.rows == 0)
+    return Ok();
+
+  std::uint32_t rows = chunk.rows;
+  put(&rows, sizeof(rows));
+
+  string raw {};
+  std::vector<Bytef> packed {};
+
+  for (std::size_t c = 0; c < schema.size(); c++) {
+    raw.clear();
+
+    if (schema[c].type == Type::Int32)
+      for (auto i : chunk.ints[c]) {
+        auto narrow = static_cast<std::int32_t>(i);
+        raw.append(reinterpret_cast<const char *>(&narrow), sizeof(narrow));
+      }
+    else if (schema[c].type == Type::Int64)
+      raw.assign(reinterpret_cast<const char *>(chunk.ints[c].data()),
+                 chunk.ints[c].size() * sizeof(std::int64_t));
+    else if (schema[c].type == Type::Double)
+      raw.assign(reinterpret_cast<const char *>(chunk.doubles[c].data()),
+                 chunk.doubles[c].size() * sizeof(double));
+    else
+      for (auto&& s : chunk.strings[c])
+        raw.append(s.c_str(), s.size() + 1);
+
+    uLongf stored = compressBound(raw.size());
+    packed.resize(stored);
+
+    std::uint8_t codec = compress(packed.data(), &stored,
+                                  reinterpret_cast<const Bytef *>(raw.data()),
+                                  raw.size()) == Z_OK && stored < raw.size();
+
+    std::uint32_t size = raw.size();
+    std::uint32_t stored_size = codec ? stored : raw.size();
+
+    put(&codec, sizeof(codec));
+    put(&size, sizeof(size));
+    put(&stored_size, sizeof(stored_size));
+    put(codec ? static_cast<const void *>(packed.data()) : raw.data(), stored_size);
+
+    chunk.ints[c].clear();
+    chunk.doubles[c].clear();
+    chunk.strings[c].clear();
+  }
+
+  chunk.rows = 0;
+
+  return Ok();
+}
+
+bool
+Writer::Close(void)
+{
+  if (!file)
+    return false;
+
+  flush();
+
+  ok = fclose(file) == 0 && ok;
+  file = nullptr;
+
+  return ok;
+}
+
+Reader::Reader(const string& path) : file(fopen(path.c_str(), "rb"))
+{
+  char m[sizeof(magic)];
+  std::uint32_t v, columns;
+
+  if (!file || !get(m, sizeof(m)) || memcmp(m, magic, sizeof(m)) != 0 ||
+      !get(&v, sizeof(v)) || v != version || !get(&columns, sizeof(columns))) {
+    ok = false;
+    return;
+  }
+
+  for (std::uint32_t c = 0; c < columns && ok; c++) {
+    std::uint32_t length;
+    Column column {};
+
+    if (!get(&length, sizeof(length)))
+      break;
+
+    column.name.resize(length);
+
+    if (get(&column.name[0], length) && get(&column.type, sizeof(column.type)))
+      schema.push_back(column);
+
+    ok = ok && column.type <= Type::String;
+  }
+}
+
+Reader::~Reader(void)
+{
+  if (file)
+    fclose(file);
+}
+
+bool
+Reader::get(void *data, std::size_t size)
+{
+  ok = ok && fread(data, 1, size, file) == size;
+  return ok;
+}
+
+bool
+Reader::Next(Chunk& chunk)
+{
+  std::uint32_t rows;
+
+  if (!Ok())
+    return false;
+
+  // The end of the file may only come between chunks
+  if (fread(&rows, 1, sizeof(rows), file) != sizeof(rows))
+    return false;
+
+  chunk.rows = rows;
+  chunk.ints.assign(schema.size(), {});
+  chunk.doubles.assign(schema.size(), {});
+  chunk.strings.assign(schema.size(), {});
+
+  string raw {};
+  std::vector<Bytef> packed {};
+
+  for (std::size_t c = 0; c < schema.size() && ok; c++) {
+    std::uint8_t codec;
+    std::uint32_t size, stored;
+
+    if (!get(&codec, sizeof(codec)) || !get(&size, sizeof(size)) || !get(&stored, sizeof(stored)))
+      return false;
+
+    raw.resize(size);
+    packed.resize(stored);
+
+    if (!get(packed.data(), stored))
+      return false;
+
+    if (codec == 0 && stored == size)
+      raw.assign(packed.begin(), packed.end());
+    else {
+      uLongf length = size;
+      ok = codec == 1 && uncompress(reinterpret_cast<Bytef *>(&raw[0]), &length,
+                                    packed.data(), stored) == Z_OK && length == size;
+    }
+
+    auto type = schema[c].type;
+    std::size_t width = type == Type::Int32 ? 4 : 8;
+
+    if (!ok || (type != Type::String && size != rows * width)) {
+      ok = false;
+      return false;
+    }
+
+    if (type == Type::Int32) {
+      chunk.ints[c].resize(rows);
+      for (std::size_t r = 0; r < rows; r++) {
+        std::int32_t i;
+        memcpy(&i, &raw[r * 4], 4);
+        chunk.ints[c][r] = i;
+      }
+    }
+    else if (type == Type::Int64) {
+      chunk.ints[c].resize(rows);
+      memcpy(chunk.ints[c].data(), raw.data(), size);
+    }
+    else if (type == Type::Double) {
+      chunk.doubles[c].resize(rows);
+      memcpy(chunk.doubles[c].data(), raw.data(), size);
+    }
+    else {
+      for (std::size_t at = 0; at < raw.size(); ) {
+        auto nul = raw.find('\0', at);
+        if (nul == string::npos)
+          break;
+
+        chunk.strings[c].emplace_back(raw, at, nul - at);
+        at = nul + 1;
+      }
+
+      ok = chunk.strings[c].size() == rows;
+    }
+  }
+
+  return ok;
+}
+
+bool FromCSV(const string& csv, const string& path)
+{
+  std::ifstream in(csv);
+  string line;
+
+  if (!std::getline(in, line)) {
+    printf("Error: could not read '%s'\n", csv.c_str());
+    return false;
+  }
+
+  std::vector<Column> schema {};
+  for (auto&& name : SplitCSV(line))
+    schema.push_back({name, Type::Int32});
+
+  // First, the narrowest type each column's values all fit
+  while (std::getline(in, line)) {
+    auto fields = SplitCSV(line);
+
+    if (fields.size() != schema.size()) {
+      printf("Error: '%s' has a row of %lu fields, not %lu\n",
+             csv.c_str(), fields.size(), schema.size());
+      return false;
+    }
+
+    std::int64_t i;
+    double d;
+
+    for (std::size_t c = 0; c < schema.size(); c++)
+      while (!parse(fields[c], schema[c].type, i, d))
+        schema[c].type = static_cast<Type>(static_cast<int>(schema[c].type) + 1);
+  }
+
+  // Then, the values
+  in.clear();
+  in.seekg(0);
+  std::getline(in, line);
+
+  Writer writer(path, schema);
+
+  while (writer.Ok() && std::getline(in, line))
+    writer.Add(SplitCSV(line));
+
+  if (!writer.Close()) {
+    printf("Error: could not write '%s'\n", path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool Verify(const string& csv, const string& path)
+{
+  std::ifstream in(csv);
+  Reader reader(path);
+  string line;
+
+  if (!std::getline(in, line) || !reader.Ok())
+    return false;
+
+  auto& schema = reader.Schema();
+
+  if (SplitCSV(line).size() != schema.size())
+    return false;
+
+  Chunk chunk;
+
+  while (reader.Next(chunk))
+    for (std::size_t r = 0; r < chunk.rows; r++) {
+      if (!std::getline(in, line))
+        return false;
+
+      auto fields = SplitCSV(line);
+
+      if (fields.size() != schema.size())
+        return false;
+
+      for (std::size_t c = 0; c < schema.size(); c++) {
+        std::int64_t i;
+        double d;
+
+        if (!parse(fields[c], schema[c].type, i, d))
+          return false;
+
+        bool same {false};
+
+        switch (schema[c].type) {
+          case Type::Int32:
+          case Type::Int64:  same = chunk.ints[c][r] == i; break;
+          case Type::Double: same = chunk.doubles[c][r] == d || \
+                                    (std::isnan(d) && std::isnan(chunk.doubles[c][r])); break;
+          case Type::String: same = chunk.strings[c][r] == fields[c]; break;
+        }
+
+        if (!same)
+          return false;
+      }
+    }
+
+  // Every row was read back, and there are no more
+  return reader.Ok() && !std::getline(in, line);
+}
+
+bool ToCSV(const string& path, FILE *out)
+{
+  Reader reader(path);
+
+  if (!reader.Ok()) {
+    fprintf(stderr, "Error: '%s' could not be read\n", path.c_str());
+    return false;
+  }
+
+  auto& schema = reader.Schema();
+
+  for (std::size_t c = 0; c < schema.size(); c++)
+    fprintf(out, c == 0 ? "%s" : ",%s", quote(schema[c].name).c_str());
+  fprintf(out, "\n");
+
+  Chunk chunk;
+  string row;
+
+  while (reader.Next(chunk))
+    for (std::size_t r = 0; r < chunk.rows; r++) {
+      row.clear();
+
+      for (std::size_t c = 0; c < schema.size(); c++) {
+        if (c > 0)
+          row += ',';
+        row += chunk.Text(schema, c, r);
+      }
+
+      row += '\n';
+      fputs(row.c_str(), out);
+    }
+
+  if (!reader.Ok()) {
+    fprintf(stderr, "Error: '%s' is corrupt\n", path.c_str());
+    return false;
+  }
+
+  return !ferror(out);
+}
+
+} // namespace Columnar
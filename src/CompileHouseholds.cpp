@@ -0,0 +1,42 @@
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+
+#include "../include/TBABM/HouseholdTemplates.h"
+
+// Converts a household structure CSV into a compiled household template
+// file, which TBABM's -h option accepts in place of the CSV.
+int main(int argc, char **argv)
+{
+  if (argc != 3) {
+    printf("Usage:\n  CompileHouseholds <household_structure.csv> <output>\n");
+    return EXIT_FAILURE;
+  }
+
+  std::unique_ptr<HouseholdTemplates> loaded {};
+
+  try {
+    loaded.reset(new HouseholdTemplates(argv[1]));
+  }
+  catch (const std::exception& e) {
+    printf("Error: %s\n", e.what());
+    return EXIT_FAILURE;
+  }
+
+  auto& templates = *loaded;
+
+  if (templates.Mapped()) {
+    printf("Error: '%s' is already compiled\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  if (!templates.Write(argv[2])) {
+    printf("Error: could not write '%s'\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  printf("Wrote %lu households to '%s'\n", templates.size(), argv[2]);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,28 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "../include/TBABM/Columnar.h"
+
+// Converts an output file between CSV and TBABM's columnar form (see
+// Columnar.h): a .tbc file given alone is written to stdout as CSV, and a
+// CSV file is written to <output> as .tbc.
+int main(int argc, char **argv)
+{
+  if (argc == 2)
+    return Columnar::ToCSV(argv[1], stdout) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+  if (argc != 3) {
+    printf("Usage:\n  ConvertOutputs <file.tbc>\n  ConvertOutputs <file.csv> <output.tbc>\n");
+    return EXIT_FAILURE;
+  }
+
+  if (!Columnar::FromCSV(argv[1], argv[2]))
+    return EXIT_FAILURE;
+
+  Columnar::Reader written(argv[2]);
+  printf("Wrote %lu columns of '%s' to '%s'\n",
+         written.Schema().size(), argv[1], argv[2]);
+
+  return EXIT_SUCCESS;
+}
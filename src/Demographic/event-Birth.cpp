@@ -20,7 +20,7 @@ EventFunc TBABM::Birth(weak_p<Individual> mother_w, weak_p<Individual> father_w)
       mother->pregnant = false;
 
       // Decide properties of baby
-      Sex sex = params["sex"].Sample(rng) ?
+      Sex sex = params.Sample(ParamID::sex, rng) ?
         Sex::Male : Sex::Female;
 
       HouseholdPosition householdPosition = HouseholdPosition::Offspring;
@@ -36,10 +36,10 @@ EventFunc TBABM::Birth(weak_p<Individual> mother_w, weak_p<Individual> father_w)
 
       // Construct baby
       auto baby = makeIndividual(
-          CreateIndividualSimContext(t, eq, rng, fileData, params),
+          CreateIndividualSimContext(t, eq, rng, fileData, params, householdService, agents),
           data,
           CreateIndividualHandlers(deathHandler, GlobalTBHandler),
-          name_gen.getName(rng),
+          Names::getName(rng),
           mother->householdID, t, sex,
           weak_p<Individual>(), mother_w, father_w,
           vector<weak_p<Individual>>{}, householdPosition, marriageStatus);
@@ -51,7 +51,7 @@ EventFunc TBABM::Birth(weak_p<Individual> mother_w, weak_p<Individual> father_w)
       if (father && !father->dead)
         father->offspring.push_back(baby);
 
-      population.push_back(baby);
+      AddToPopulation(baby);
 
       ChangeHousehold(baby, t, mother->householdID, householdPosition);
 
@@ -62,7 +62,7 @@ EventFunc TBABM::Birth(weak_p<Individual> mother_w, weak_p<Individual> father_w)
       data.births.Record(t, +1);
 
       // Schedule the next birth
-      auto yearsToNextBirth = fileData["timeToSubsequentBirths"].getValue(0,0,(t-mother->birthDate)/365,rng);
+      auto yearsToNextBirth = fileData[FrameID::timeToSubsequentBirths].getValue(0,0,(t-mother->birthDate)/365,rng);
       auto daysToNextBirth = 365*yearsToNextBirth;
 
       Schedule(t + daysToNextBirth - 9*30, Pregnancy(mother, mother->spouse));
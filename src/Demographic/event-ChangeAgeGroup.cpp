@@ -11,12 +11,12 @@ using std::map;
 using EventFunc = TBABM::EventFunc;
 using SchedulerT = EventQueue<double,bool>::SchedulerT;
 
-auto findHousehold = [] (map<long, shared_p<Household>> &households) -> long {
-  for (auto household : households)
-    if (household.second && 
-        household.second->size() > 0 &&
-        household.second->size() < 5)
-      return household.first;
+auto findHousehold = [] (HouseholdTable &households) -> long {
+  for (std::size_t hid = 0; hid < households.size(); hid++)
+    if (households[hid] && 
+        households[hid]->size() > 0 &&
+        households[hid]->size() < 5)
+      return hid;
 
   return -1;
 };
@@ -42,7 +42,7 @@ EventFunc TBABM::ChangeAgeGroup(weak_p<Individual> idv_w)
       auto startYear = constants["startYear"];
       int gender = idv->sex == Sex::Male ? 0 : 1;
       double age = idv->age(t);
-      double timeToDeath = 365 * fileData["naturalDeath"].getValue(startYear+(int)t/365, gender, age, rng);
+      double timeToDeath = 365 * fileData[FrameID::naturalDeath].getValue(startYear+(int)t/365, gender, age, rng);
 
       bool scheduledDeath = false;
       if (timeToDeath < timeToNextEvent) {
@@ -54,7 +54,7 @@ EventFunc TBABM::ChangeAgeGroup(weak_p<Individual> idv_w)
       // Leaving the current household to form a new household
       //////////////////////////////////////////////////////
       bool idvIsHead = idv->householdPosition == HouseholdPosition::Head;
-      double timeToLeave = 365*params["leavingHousehold"].Sample(rng);
+      double timeToLeave = 365*params.Sample(ParamID::leavingHousehold, rng);
       if (!idv->spouse.lock() && 
           age >= 18 && 
           age <= 55 && 
@@ -67,8 +67,8 @@ EventFunc TBABM::ChangeAgeGroup(weak_p<Individual> idv_w)
       ////////////////////////////////////////////////////
       // Change of marital status from single to looking
       ////////////////////////////////////////////////////
-      double scale  = params["timeToLookingScale"].Sample(rng);
-      double sample = fileData["timeToLooking"].getValue(0,gender,(t-idv->birthDate)/365,rng);
+      double scale  = params.Sample(ParamID::timeToLookingScale, rng);
+      double sample = fileData[FrameID::timeToLooking].getValue(0,gender,(t-idv->birthDate)/365,rng);
       double timeToLook = 365 * scale * sample;
       if ((idv->marriageStatus == MarriageStatus::Single ||
             idv->marriageStatus == MarriageStatus::Divorced)
@@ -5,6 +5,8 @@
 #include <cassert>
 #include <fstream>
 #include <iostream>
+#include <atomic>
+#include <thread>
 
 using namespace StatisticalDistributions;
 using std::vector;
@@ -12,9 +14,19 @@ using EventFunc = TBABM::EventFunc;
 using SchedulerT = EventQueue<double,bool>::SchedulerT;
 
 // Algorithm S2: Create a population at simulation time 0
+//
+// Households are built one after another, as everyone in them is bound to
+// this trajectory's RNG and event queue from the moment they are made.
+// What each individual is then to do first (die, look for a partner, give
+// birth, or be infected with HIV) is drawn for chunks of 'initChunk'
+// individuals on up to 'initThreads' threads, each chunk from an RNG of its
+// own, seeded from 'rng' in chunk order; and only then scheduled, in order
+// of the population. So the population is the same for a given seed and
+// chunk size, whatever the number of threads.
 void TBABM::CreatePopulation(int t, long size)
 {
   int popChange = 0;
+  std::size_t first = population.size();
 
   while (popChange < size) {
     long hid = nHouseholds++;
@@ -27,41 +39,38 @@ void TBABM::CreatePopulation(int t, long size)
     double dt = constants["ageGroupWidth"] - fmod(hh->head->age<double>(t), constants["ageGroupWidth"]);
 
     // Insert all members of the household into the population
-    population.push_back(hh->head); popChange++;
+    AddToPopulation(hh->head); popChange++;
     assert(hh->head->householdID == hid);
-    InitialEvents(hh->head, t, dt);
     Schedule(t + 365*dt, ChangeAgeGroup(hh->head));
     if (hh->spouse) {
       double dt = constants["ageGroupWidth"] - fmod(hh->spouse->age<double>(t), constants["ageGroupWidth"]);
       popChange++;
-      population.push_back(hh->spouse);
+      AddToPopulation(hh->spouse);
       assert(hh->spouse->householdID == hid);
-      InitialEvents(hh->spouse, t, dt);
       Schedule(t + dt, ChangeAgeGroup(hh->spouse));
 
       // Set marriage age
       double spouseAge = (t - hh->spouse->birthDate)/365.;
       double headAge = (t - hh->head->birthDate)/365.;
-      hh->spouse->marriageDate = t - 365*fileData["timeInMarriage"].getValue(0,0,spouseAge,rng);
-      hh->head->marriageDate   = t - 365*fileData["timeInMarriage"].getValue(0,0,headAge, rng);
+      hh->spouse->marriageDate = t - 365*fileData[FrameID::timeInMarriage].getValue(0,0,spouseAge,rng);
+      hh->head->marriageDate   = t - 365*fileData[FrameID::timeInMarriage].getValue(0,0,headAge, rng);
     }
     for (auto it = hh->offspring.begin(); it != hh->offspring.end(); it++) {
       double dt = constants["ageGroupWidth"] - fmod((*it)->age<double>(t), constants["ageGroupWidth"]);
       popChange++;
-      population.push_back((*it));
+      AddToPopulation(*it);
       assert((*it)->householdID == hid);
       Schedule(t + dt, ChangeAgeGroup(*it));
-      InitialEvents(*it, t, dt);
     }
     for (auto it = hh->other.begin(); it != hh->other.end(); it++) {
       double dt = constants["ageGroupWidth"] - fmod((*it)->age<double>(t), constants["ageGroupWidth"]);
       popChange++;
-      population.push_back((*it));
+      AddToPopulation(*it);
       assert((*it)->householdID == hid);
       Schedule(t + dt, ChangeAgeGroup(*it));
 
       if ((*it)->marriageStatus != MarriageStatus::Married &&
-          params["otherMarried"].Sample(rng) == 1) {
+          params.Sample(ParamID::otherMarried, rng) == 1) {
         auto it2 = it;
         it2++;
         for (; it2 != hh->other.end(); it2++)
@@ -75,47 +84,83 @@ void TBABM::CreatePopulation(int t, long size)
 
             male->spouse = female;
             male->marriageStatus = MarriageStatus::Married;
-            male->marriageDate = t - 365*fileData["timeInMarriage"].getValue(0,0,male->age(t),rng);
+            male->marriageDate = t - 365*fileData[FrameID::timeInMarriage].getValue(0,0,male->age(t),rng);
 
             female->spouse = male;
             female->marriageStatus = MarriageStatus::Married;
-            female->marriageDate = t - 365*fileData["timeInMarriage"].getValue(0,0,female->age(t),rng);
+            female->marriageDate = t - 365*fileData[FrameID::timeInMarriage].getValue(0,0,female->age(t),rng);
 
             break;
           }
       }
-
-      InitialEvents(*it, t, dt);
     }
   }
 
-  // Decide whether each female is pregnant, and who has HIV. Schedule
-  // HIV infection checks
-  for (auto it = population.begin(); it != population.end(); it++) {
-    auto person = *it;
+  std::size_t n = population.size() - first;
 
-    if (person->sex == Sex::Male || \
-        !person->spouse.lock() || \
-        person->age(t) < 15)
-      continue;
+  auto lookup = [this] (const char *name, long fallback) -> long {
+    auto c = constants.find(name);
+    return c != constants.end() && c->second >= 1 ? static_cast<long>(c->second) : fallback;
+  };
 
-    bool hasKids {person->offspring.size() > 0};
+  std::size_t chunk    = lookup("initChunk", 4096);
+  std::size_t chunks   = (n + chunk - 1) / chunk;
+  std::size_t nThreads = std::min<std::size_t>(lookup("initThreads", 1), chunks);
 
-    auto birthDistribution = hasKids ? fileData["timeToSubsequentBirths"] : \
-                             fileData["timeToFirstBirth"];
+  // A distribution-valued timeToLookingScale, as a sweep may make it, is
+  // sampled through one distribution object, so its chunks are drawn on
+  // this thread alone. They are drawn from the same RNGs either way.
+  if (!params.IsConstant(ParamID::timeToLookingScale))
+    nThreads = 1;
 
-    double yearsToBirth = birthDistribution.getValue(0, 0, person->age(t), rng);
-    int daysToFirstBirth = 365 * yearsToBirth;
+  vector<std::uint_fast64_t> seeds {};
+  for (std::size_t k = 0; k < chunks; k++)
+    seeds.push_back(rng.mt_());
 
-    Schedule(t + daysToFirstBirth - 9*30, Pregnancy(person, person->spouse));
+  vector<InitialDraws> draws(n);
+  std::atomic<std::size_t> next {0};
+
+  auto drawChunks = [this, t, n, chunk, chunks, first, &seeds, &draws, &next] {
+    for (std::size_t k; (k = next++) < chunks; ) {
+      RNG chunkRNG(seeds[k]);
+
+      for (std::size_t i = k * chunk; i < std::min(n, (k + 1) * chunk); i++)
+        draws[i] = DrawInitialEvents(*population[first + i], t, chunkRNG);
+    }
+  };
+
+  vector<std::thread> threads {};
+  for (std::size_t i = 1; i < nThreads; i++)
+    threads.emplace_back(drawChunks);
+
+  drawChunks();
+
+  for (auto& thread : threads)
+    thread.join();
+
+  // Schedule natural deaths and looking for a partner
+  for (std::size_t i = 0; i < n; i++) {
+    auto person = population[first + i];
+    double dt = constants["ageGroupWidth"] - fmod(person->age<double>(t), constants["ageGroupWidth"]);
+
+    InitialEvents(person, t, dt, draws[i]);
   }
 
-  for (auto it = population.begin(); it != population.end(); it++) {
+  // Schedule pregnancies, and HIV infection checks
+  for (std::size_t i = 0; i < n; i++) {
+    if (!draws[i].pregnant)
+      continue;
 
-    auto person = *it;
-    int gender = person->sex == Sex::Male ? 0 : 1;
+    auto person = population[first + i];
+    int daysToFirstBirth = 365 * draws[i].yearsToBirth;
+
+    Schedule(t + daysToFirstBirth - 9*30, Pregnancy(person, person->spouse));
+  }
+
+  for (std::size_t i = 0; i < n; i++) {
+    auto person = population[first + i];
 
-    if (fileData["HIV_prevalence_1990"].getValue(1990, gender, person->age(t), rng) == 1)
+    if (draws[i].hivPositive)
       Schedule(t, HIVInfection(person));
     else
       Schedule(t + 365, HIVInfectionCheck(person));
@@ -109,30 +109,31 @@ EventFunc TBABM::Death(weak_p<Individual> idv_w, DeathCause deathCause)
 
 void TBABM::SurveyDeath(shared_p<Individual> idv, int t, DeathCause deathCause)
 {
-  string s = ",";
-
-  string line = to_string(seed) + s
-    + to_string(t) + s
-    + Ihash(idv) + s
-    + age(idv, t) + s
-    + sex(idv) + s
-    + causeDeath(deathCause) + s
-    + HIV(idv) + s 
-    + HIV_date(idv) + s 
-    + ART(idv) + s 
-    + ART_date(idv) + s 
-    + CD4(idv, t, params["HIV_m_30"].Sample(rng)) + s
-    + ART_baseline_CD4(idv, params["HIV_m_30"].Sample(rng))
-    + "\n";
-
-  deathSurvey += line;
+  auto& row = surveyRow;
+
+  row.Clear();
+  row << static_cast<long>(seed)
+      << t
+      << ID(idv)
+      << age(idv, t)
+      << sex(idv)
+      << causeDeath(deathCause)
+      << HIV(idv)
+      << HIV_date(idv)
+      << ART(idv)
+      << ART_date(idv)
+      << CD4(idv, t, params.Sample(ParamID::HIV_m_30, rng))
+      << ART_baseline_CD4(idv, params.Sample(ParamID::HIV_m_30, rng));
+  row.End();
+
+  SurveyRows(SurveyKind::Death, row.Text());
 
   return;
 }
 
 // - trajectory
 // - time: in days
-// - hash
+// - ID ('hash'): numbered within the trajectory, from 0
 // - age: in years
 // - sex: male/female
 // - cause: HIV/natural
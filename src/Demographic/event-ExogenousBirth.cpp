@@ -64,7 +64,7 @@ EventFunc TBABM::ExogenousBirth(void)
       int n = data.populationSize(t);
 
       // Grab annual birth rate of the population
-      double annualBirthRate = params["annualBirthRate"].Sample(rng);
+      double annualBirthRate = params.Sample(ParamID::annualBirthRate, rng);
 
       // Calculate the monthly expected number of births
       double rate = n * annualBirthRate * 1./12;
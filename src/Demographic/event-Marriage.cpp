@@ -51,7 +51,7 @@ EventFunc TBABM::Marriage(weak_p<Individual> m_weak, weak_p<Individual> f_weak)
 
       } else {
         // Couple forms new household?
-        if (params["coupleFormsNewHousehold"].Sample(rng) == 1) {
+        if (params.Sample(ParamID::coupleFormsNewHousehold, rng) == 1) {
           auto hid = nHouseholds++;
           households[hid] = std::make_shared<Household>(t, hid);
 
@@ -87,17 +87,17 @@ EventFunc TBABM::Marriage(weak_p<Individual> m_weak, weak_p<Individual> f_weak)
       f->marriageDate = t;
 
       // Will they divorce?
-      if (params["probabilityOfDivorce"].Sample(rng) == 1 && canDivorce) {
+      if (params.Sample(ParamID::probabilityOfDivorce, rng) == 1 && canDivorce) {
         // Time to divorce
         double coupleAvgAge = (m->age(t) + f->age(t))/(2*365);
-        double yearsToDivorce = fileData["timeInMarriage"].getValue(0,0,coupleAvgAge,rng);
+        double yearsToDivorce = fileData[FrameID::timeInMarriage].getValue(0,0,coupleAvgAge,rng);
         int daysToDivorce = 365 * yearsToDivorce;
         Schedule(t + daysToDivorce, Divorce(m, f));
       }
 
 
       // Time to first birth
-      double yearsToFirstBirth = fileData["timeToFirstBirth"].getValue(0,0,f->age(t),rng);
+      double yearsToFirstBirth = fileData[FrameID::timeToFirstBirth].getValue(0,0,f->age(t),rng);
       int daysToFirstBirth = 365 * yearsToFirstBirth;
 
       Schedule(t + daysToFirstBirth - 9*30, Pregnancy(m, f));
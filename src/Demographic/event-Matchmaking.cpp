@@ -70,7 +70,7 @@ EventFunc TBABM::Matchmaking(void)
           // Calculate the weight of this pairing as a function of the age diff
           // between the pair under consideration, update the denominator
           // with this weight, and push the weight onto the 'weights' vector.
-          long double weight = params["marriageAgeDifference"].pdf(ageDifference);
+          long double weight = params[ParamID::marriageAgeDifference].pdf(ageDifference);
           denominator += weight;
           weights.push_back(weight);
 
@@ -24,18 +24,18 @@ EventFunc TBABM::NewHouseholds(int num)
         households[hid] = hh;
 
         // Insert all members of the household into the population
-        population.push_back(hh->head); popChange++;
+        AddToPopulation(hh->head); popChange++;
         if (hh->spouse){
-          population.push_back(hh->spouse);
+          AddToPopulation(hh->spouse);
           popChange++;
         }
         for (auto it = hh->offspring.begin(); it != hh->offspring.end(); it++) {
           popChange++;
-          population.push_back(*it);
+          AddToPopulation(*it);
         }
         for (auto it = hh->other.begin(); it != hh->other.end(); it++) {
           popChange++;
-          population.push_back(*it);
+          AddToPopulation(*it);
         }
       }
 
@@ -11,8 +11,7 @@ EventFunc TBABM::Survey(void)
 
   EventFunc ef = 
     [this] (double t, SchedulerT scheduler) {
-      string buf;
-      string s = ",";
+      auto& row = surveyRow;
 
       printf("[%5d] Survey\n", (int)t);
 
@@ -29,34 +28,33 @@ EventFunc TBABM::Survey(void)
 
         if (!hh || hh->size() == 0) continue;
 
-        string line = to_string(seed) + s
-          + to_string(t) + s
-          + Ihash(idv) + s
-          + age(idv, t) + s
-          + sex(idv) + s
-          + marital(idv) + s
-          + to_string(households[idv->householdID]->size()) + s
-          + Hhash(hh) + s
-          + numChildren(idv) + s
-          + mom(idv) + s
-          + dad(idv) + s
-          + HIV(idv) + s
-          + ART(idv) + s
-          + CD4(idv, t, params["HIV_m_30"].Sample(rng)) + s
-          + TBStatus(idv, t)
-          + "\n";
-
-        buf += line;
+        // The trajectory is its seed written signed, as in the series
+        row.Clear();
+        row << static_cast<long>(seed)
+            << t
+            << ID(idv)
+            << age(idv, t)
+            << sex(idv)
+            << marital(idv)
+            << hh->size()
+            << ID(hh)
+            << numChildren(idv)
+            << mom(idv)
+            << dad(idv)
+            << HIV(idv)
+            << ART(idv)
+            << CD4(idv, t, params.Sample(ParamID::HIV_m_30, rng))
+            << TBStatus(idv, t);
+        row.End();
+
+        SurveyRows(SurveyKind::Population, row.Text());
       }
 
-      populationSurvey += buf;
-      buf.clear();
-
       ///////////////////////////////////////////////////////
       // Household survey
       ///////////////////////////////////////////////////////
       for (auto it = households.begin(); it != households.end(); it++) {
-        auto hh = it->second;
+        auto hh = *it;
 
         if (!hh || hh->size() == 0) continue;
 
@@ -73,22 +71,21 @@ EventFunc TBABM::Survey(void)
           else
             otherOffspring += 1;
 
-        string line = to_string(seed) 		      + s \
-                      + to_string(t)    		      + s \
-                      + Hhash(hh)		  		      + s \
-                      + to_string(hh->size())       + s \
-                      + to_string(!!hh->head)       + s \
-                      + to_string(!!hh->spouse)     + s \
-                      + to_string(directOffspring)  + s \
-                      + to_string(otherOffspring)   + s \
-                      + to_string(hh->other.size())     \
-                      + "\n";
-
-        buf += line;
+        row.Clear();
+        row << static_cast<long>(seed)
+            << t
+            << ID(hh)
+            << hh->size()
+            << !!hh->head
+            << !!hh->spouse
+            << directOffspring
+            << otherOffspring
+            << hh->other.size();
+        row.End();
+
+        SurveyRows(SurveyKind::Household, row.Text());
       }
 
-      householdSurvey += buf;
-
       Schedule(t + 15*365, Survey());
 
       return true;
@@ -101,12 +98,12 @@ EventFunc TBABM::Survey(void)
 // for each person:
 //  - seed of trajectory they're in
 //  - time
-// 	- hash
+// 	- ID ('hash')
 // 	- age
 // 	- sex
 // 	- single, married, divorced, or looking
 // 	- household size
-// 	- household hash
+// 	- household ID ('householdHash')
 // 	- number of children
 // 	- mom alive?
 // 	- dad alive?
@@ -114,7 +111,7 @@ EventFunc TBABM::Survey(void)
 // 	for each household:
 // 	- trajectory
 // 	- time
-// 	- hash
+// 	- ID ('hash')
 // 	- size
 // 	- head
 // 	- spouse
@@ -20,7 +20,7 @@ EventFunc TBABM::UpdateHouseholds(void)
   EventFunc ef = 
     [this] (double t, SchedulerT scheduler) {
       for (auto it = households.begin(); it != households.end(); it++) {
-        if (!it->second)
+        if (!*it)
           continue;
 
         data.householdsCount.Record(t, +1);
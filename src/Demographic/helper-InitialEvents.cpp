@@ -12,29 +12,55 @@ using SchedulerT = EventQueue<double,bool>::SchedulerT;
 
 using namespace StatisticalDistributions;
 
-// Unit of dt is years
-void TBABM::InitialEvents(weak_p<Individual> idv_w, double t, double dt)
+// Touches nothing of the trajectory's but 'idv', what is read-only (the
+// frames and constants) and the parameter timeToLookingScale. So it may be
+// called for different individuals on different threads, each with an RNG
+// of its own, only while that parameter is folded to a constant: sampling
+// a distribution isn't thread-safe (see CreatePopulation).
+TBABM::InitialDraws
+TBABM::DrawInitialEvents(Individual& idv, double t, RNG& rng)
 {
-  auto idv = idv_w.lock();
-  if (!idv)
-    return;
+  InitialDraws draws {};
 
-  int gender = idv->sex == Sex::Male ? 0 : 1;
-  double age = idv->age(t);
-  auto startYear = constants["startYear"];
+  int gender = idv.sex == Sex::Male ? 0 : 1;
+  double age = idv.age(t);
+  auto startYear = constants.at("startYear");
 
   // Unit of both of these is years
-  double timeToDeath   = fileData["naturalDeath"].getValue(startYear+(int)t/365, gender, age, rng);
-  double timeToLookingScale = params["timeToLookingScale"].Sample(rng);
-  double timeToLooking = timeToLookingScale * fileData["timeToLooking"].getValue(0, gender, age, rng);
+  draws.timeToDeath   = fileData[FrameID::naturalDeath].getValue(startYear+(int)t/365, gender, age, rng);
+  double timeToLookingScale = params.Sample(ParamID::timeToLookingScale, rng);
+  draws.timeToLooking = timeToLookingScale * fileData[FrameID::timeToLooking].getValue(0, gender, age, rng);
+
+  // Whether each female is pregnant
+  if (idv.sex == Sex::Female && \
+      idv.spouse.lock() && \
+      idv.age(t) >= 15) {
+    bool hasKids {idv.offspring.size() > 0};
+
+    auto& birthDistribution = hasKids ? fileData[FrameID::timeToSubsequentBirths] : \
+                              fileData[FrameID::timeToFirstBirth];
+
+    draws.pregnant     = true;
+    draws.yearsToBirth = birthDistribution.getValue(0, 0, idv.age(t), rng);
+  }
+
+  // And who has HIV
+  draws.hivPositive = fileData[FrameID::HIV_prevalence_1990].getValue(1990, gender, idv.age(t), rng) == 1;
 
-  if (timeToDeath < dt)
-    Schedule(t + 365*timeToDeath, Death(idv, DeathCause::Natural));
+  return draws;
+}
+
+// Unit of dt is years
+void TBABM::InitialEvents(shared_p<Individual> idv, double t, double dt,
+                          const InitialDraws& draws)
+{
+  if (draws.timeToDeath < dt)
+    Schedule(t + 365*draws.timeToDeath, Death(idv, DeathCause::Natural));
 
   if ((idv->marriageStatus == MarriageStatus::Single ||
         idv->marriageStatus == MarriageStatus::Divorced) &&
-      timeToLooking < dt)
-    Schedule(t + 365*timeToLooking, SingleToLooking(idv));
+      draws.timeToLooking < dt)
+    Schedule(t + 365*draws.timeToLooking, SingleToLooking(idv));
 
   return;
 }
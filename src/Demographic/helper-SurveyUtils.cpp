@@ -2,26 +2,24 @@
 
 using MS = MarriageStatus;
 
-using std::to_string;
-
-string Ihash(shared_p<Individual> idv) {
-  return to_string(std::hash<shared_p<Individual>>()(idv));
+long ID(shared_p<Individual> idv) {
+  return idv->id;
 }
 
-string Hhash(shared_p<Household> hh) {
-  return to_string(std::hash<shared_p<Household>>()(hh));
+long ID(shared_p<Household> hh) {
+  return hh->ID();
 }
 
 
-string age(shared_p<Individual> idv, int t) {
-  return to_string(idv->age(t));
+int age(shared_p<Individual> idv, int t) {
+  return idv->age(t);
 }
 
-string sex(shared_p<Individual> idv) {
+const char *sex(shared_p<Individual> idv) {
   return idv->sex == Sex::Male ? "male" : "female";
 }
 
-string marital(shared_p<Individual> idv) {
+const char *marital(shared_p<Individual> idv) {
   switch (idv->marriageStatus) {
     case MS::Single:   return "single";   break;			
     case MS::Married:  return "married";  break;
@@ -31,11 +29,11 @@ string marital(shared_p<Individual> idv) {
   }
 }
 
-string numChildren(shared_p<Individual> idv) {
-  return to_string(idv->numOffspring());
+int numChildren(shared_p<Individual> idv) {
+  return idv->numOffspring();
 }
 
-string mom(shared_p<Individual> idv) {
+const char *mom(shared_p<Individual> idv) {
   assert(idv);
 
   auto mom = idv->mother.lock();
@@ -45,7 +43,7 @@ string mom(shared_p<Individual> idv) {
     return mom->dead ? "dead" : "alive";
 }
 
-string dad(shared_p<Individual> idv) {
+const char *dad(shared_p<Individual> idv) {
   assert(idv);
 
   auto father = idv->father.lock();
@@ -56,7 +54,7 @@ string dad(shared_p<Individual> idv) {
 }
 
 
-string causeDeath(DeathCause cause_death) {
+const char *causeDeath(DeathCause cause_death) {
   switch (cause_death) {
     case DeathCause::HIV:      return "HIV";      break;			
     case DeathCause::Natural:  return "natural";  break;
@@ -65,34 +63,34 @@ string causeDeath(DeathCause cause_death) {
   }
 }
 
-string HIV(shared_p<Individual> idv) {
+const char *HIV(shared_p<Individual> idv) {
   return idv->hivStatus == HIVStatus::Positive ? "true" : "false";
 }
 
-string HIV_date(shared_p<Individual> idv) {
+int HIV_date(shared_p<Individual> idv) {
   if (idv->hivStatus == HIVStatus::Positive)
-    return to_string(idv->t_HIV_infection);
+    return idv->t_HIV_infection;
   else
-    return to_string(0);
+    return 0;
 }
 
-string ART(shared_p<Individual> idv) {
+const char *ART(shared_p<Individual> idv) {
   return idv->onART ? "true" : "false";
 }
 
-string ART_date(shared_p<Individual> idv) {
-  return to_string(idv->onART ? idv->ARTInitTime : 0);
+int ART_date(shared_p<Individual> idv) {
+  return idv->onART ? idv->ARTInitTime : 0;
 }
 
-string CD4(shared_p<Individual> idv, double t, double m_30) {
-  return to_string(idv->CD4count(t, m_30));
+double CD4(shared_p<Individual> idv, double t, double m_30) {
+  return idv->CD4count(t, m_30);
 }
 
-string ART_baseline_CD4(shared_p<Individual> idv, double m_30) {
-  return to_string(idv->onART ? idv->ART_init_CD4 : 0);
+double ART_baseline_CD4(shared_p<Individual> idv, double m_30) {
+  return idv->onART ? idv->ART_init_CD4 : 0;
 }
 
-string TBStatus(shared_p<Individual> idv, int t) {
+const char *TBStatus(shared_p<Individual> idv, int t) {
   switch (idv->tb.GetTBStatus(t)) {
     case TBStatus::Susceptible: return "Susceptible"; break;
     case TBStatus::Latent:		return "Latent"; break;
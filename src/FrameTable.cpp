@@ -0,0 +1,235 @@
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <Bernoulli.h>
+#include <Exponential.h>
+#include <JohnsonSb.h>
+#include <Weibull.h>
+
+#include "../include/TBABM/FrameTable.h"
+
+using namespace StatisticalDistributions;
+using namespace SimulationLib::JSONImport;
+
+namespace {
+
+const char *names[] = {
+#define TBABM_FRAME(name, required) #name,
+#include "../include/TBABM/FrameNames.inc"
+#undef TBABM_FRAME
+};
+
+const bool required[] = {
+#define TBABM_FRAME(name, required) required,
+#include "../include/TBABM/FrameNames.inc"
+#undef TBABM_FRAME
+};
+
+// csvjson leaves a column as text if any of its cells isn't a number (the
+// '-' placeholders in the header rows do this), so numbers may be strings
+bool ToNumber(const json& v, double& out)
+{
+  if (v.is_number()) {
+    out = v.get<double>();
+    return true;
+  }
+
+  if (!v.is_string())
+    return false;
+
+  auto s = v.get<string>();
+  char *end {nullptr};
+
+  out = std::strtod(s.c_str(), &end);
+
+  return !s.empty() && *end == '\0';
+}
+
+double NumberOr(const json& row, const char *key, double otherwise)
+{
+  double v;
+
+  if (row.count(key) && ToNumber(row[key], v))
+    return v;
+
+  return otherwise;
+}
+
+int Category(double x, double start, double width, int n)
+{
+  auto i = static_cast<int>(std::floor((x - start) / width));
+
+  return i < 0 ? 0 : (i >= n ? n-1 : i);
+}
+
+[[noreturn]] void Malformed(const char *name, const char *reason)
+{
+  throw std::runtime_error("data frame '" + string(name) + "' is malformed: " + reason);
+}
+
+} // namespace
+
+CompiledFrame::CompiledFrame(const json& frame, const char *name)
+{
+  if (!frame.is_array() || frame.size() < 3)
+    Malformed(name, "expected two header rows and at least one cell");
+
+  auto& widths = frame[0];
+  auto& counts = frame[1];
+
+  double v;
+
+  has_year = widths.count("year") && ToNumber(widths["year"], v);
+
+  for (std::size_t i = 2; i < frame.size(); i++) {
+    auto& row = frame[i];
+    if (row.count("sex") && row["sex"].is_string() && \
+        (row["sex"] == "M" || row["sex"] == "F"))
+      has_sex = true;
+  }
+
+  year_width = has_year ? NumberOr(widths, "year", 1) : 1;
+  n_years    = has_year ? static_cast<int>(NumberOr(counts, "year", 1)) : 1;
+  age_width  = NumberOr(widths, "age", 1);
+  n_ages     = static_cast<int>(NumberOr(counts, "age", 1));
+
+  if (year_width <= 0 || age_width <= 0 || n_years < 1 || n_ages < 1)
+    Malformed(name, "header rows have nonpositive widths or counts");
+
+  // The first category of each dimension is the smallest value it takes
+  year_start = INFINITY;
+  age_start  = INFINITY;
+
+  for (std::size_t i = 2; i < frame.size(); i++) {
+    if (has_year)
+      year_start = std::fmin(year_start, NumberOr(frame[i], "year", INFINITY));
+    age_start = std::fmin(age_start, NumberOr(frame[i], "age", INFINITY));
+  }
+
+  if (!has_year)
+    year_start = 0;
+
+  if (std::isinf(year_start) || std::isinf(age_start))
+    Malformed(name, "no cell has a numeric year or age");
+
+  int n_sexes {has_sex ? 2 : 1};
+
+  cells.resize(n_years * n_sexes * n_ages);
+  std::vector<bool> filled(cells.size(), false);
+
+  for (std::size_t i = 2; i < frame.size(); i++) {
+    auto& row = frame[i];
+
+    double year = has_year ? NumberOr(row, "year", NAN) : 0;
+    double age  = NumberOr(row, "age", NAN);
+
+    if (std::isnan(year) || std::isnan(age))
+      Malformed(name, "a cell has a nonnumeric year or age");
+
+    auto yi = std::lround((year - year_start) / year_width);
+    auto ai = std::lround((age  - age_start)  / age_width);
+    int  si = has_sex && row.count("sex") && row["sex"] == "F" ? 1 : 0;
+
+    if (yi >= n_years || ai >= n_ages)
+      Malformed(name, "a cell lies outside the bounds given in the header");
+
+    auto index = (yi * n_sexes + si) * n_ages + ai;
+
+    string dist = row.count("distribution") && row["distribution"].is_string() ? \
+                  row["distribution"].get<string>() : "";
+
+    Cell cell {};
+
+    if (dist == "Constant")
+      cell.kind = Kind::Constant;
+    else if (dist == "Bernoulli")
+      cell.kind = Kind::Bernoulli;
+    else if (dist == "Exponential")
+      cell.kind = Kind::Exponential;
+    else if (dist == "Weibull")
+      cell.kind = Kind::Weibull;
+    else if (dist == "Johnson Sb" || dist == "JohnsonSb")
+      cell.kind = Kind::JohnsonSb;
+    else
+      throw std::runtime_error("data frame '" + string(name) + \
+                               "' uses unknown distribution '" + dist + "'");
+
+    cell.p[0] = NumberOr(row, "parameter-1", 0);
+    cell.p[1] = NumberOr(row, "parameter-2", 0);
+    cell.p[2] = NumberOr(row, "parameter-3", 0);
+    cell.p[3] = NumberOr(row, "parameter-4", 0);
+
+    // A row repeated word for word, as some of the shipped frames have,
+    // is the same cell; two that disagree are a mistake
+    if (filled[index] && (cell.kind != cells[index].kind || \
+                          !std::equal(cell.p, cell.p + 4, cells[index].p)))
+      Malformed(name, "two rows describe the same cell differently");
+
+    cells[index]  = cell;
+    filled[index] = true;
+  }
+
+  for (auto&& f : filled)
+    if (!f)
+      Malformed(name, "fewer cells than the header rows call for");
+}
+
+std::size_t
+CompiledFrame::Index(double year, int sex, double age) const
+{
+  int yi = has_year ? Category(year, year_start, year_width, n_years) : 0;
+  int ai = Category(age, age_start, age_width, n_ages);
+  int si = has_sex && sex != 0 ? 1 : 0;
+
+  return (yi * (has_sex ? 2 : 1) + si) * n_ages + ai;
+}
+
+double
+CompiledFrame::getValue(double year, int sex, double age, RNG& rng) const
+{
+  auto& c = cells[Index(year, sex, age)];
+
+  switch (c.kind) {
+    case Kind::Constant:    return c.p[0];
+    case Kind::Bernoulli:   return Bernoulli(c.p[0])(rng.mt_);
+    case Kind::Exponential: return c.p[1] + Exponential(c.p[0])(rng.mt_);
+    case Kind::Weibull:     return Weibull(c.p[0], c.p[1])(rng.mt_);
+    case Kind::JohnsonSb:   return JohnsonSb(c.p[0], c.p[1], c.p[2], c.p[3])(rng.mt_);
+  }
+
+  return 0;
+}
+
+FrameTable::FrameTable(const ParamTable::FileList& files)
+{
+  std::vector<string> missing {};
+
+  for (std::size_t i = 0; i < table.size(); i++) {
+    auto it = std::find_if(files.begin(), files.end(),
+        [i] (const std::pair<string, string>& f) { return f.first == names[i]; });
+
+    if (it != files.end())
+      table[i] = CompiledFrame(fileToJSON(it->second), names[i]);
+    else if (required[i])
+      missing.emplace_back(names[i]);
+  }
+
+  if (missing.size() > 0) {
+    string error {"the parameter file is missing " + std::to_string(missing.size()) + \
+                  " required data frame(s):"};
+
+    for (auto&& name : missing)
+      error += " " + name;
+
+    throw std::runtime_error(error);
+  }
+}
+
+const char *
+FrameTable::Name(FrameID id)
+{
+  return names[static_cast<std::size_t>(id)];
+}
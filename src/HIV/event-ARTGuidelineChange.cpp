@@ -21,14 +21,14 @@ EventFunc TBABM::ARTGuidelineChange(void)
         }
 
         bool initiateART;
-        double m_30 = params["HIV_m_30"].Sample(rng);
+        double m_30 = params.Sample(ParamID::HIV_m_30, rng);
         double CD4 = idv->CD4count(t, m_30);
 
         // [0,1] is cast to bool here
         if (idv->tb.GetTBStatus(t) == TBStatus::Infectious)
-          initiateART = fileData["HIV_p_art_tb"].getValue(0, 0, CD4, rng);
+          initiateART = fileData[FrameID::HIV_p_art_tb].getValue(0, 0, CD4, rng);
         else
-          initiateART = fileData["HIV_p_art"].getValue(0, 0, CD4, rng);
+          initiateART = fileData[FrameID::HIV_p_art].getValue(0, 0, CD4, rng);
 
         if (ARTEligible(t, idv) && initiateART) {
           Schedule(t, ARTInitiate(idv));
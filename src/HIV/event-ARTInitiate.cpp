@@ -19,7 +19,7 @@ EventFunc TBABM::ARTInitiate(weak_p<Individual> idv_w)
       if (idv->dead || idv->hivStatus != HIVStatus::Positive)
         return true;
 
-      double m_30   = params["HIV_m_30"].Sample(rng);
+      double m_30   = params.Sample(ParamID::HIV_m_30, rng);
       int CD4       = idv->CD4count(t, m_30);
       // printf("[%d] ARTInitiate: %ld::%lu, CD4=%d\n", (int)t, idv->householdID, \
       // std::hash<Pointer<Individual>>()(idv), CD4);
@@ -37,8 +37,8 @@ EventFunc TBABM::HIVInfection(weak_p<Individual> idv_w)
       idv->hivStatus = HIVStatus::Positive;
 
       // Decide CD4 count and value of 'k', and record as undiagnosed
-      idv->initialCD4 = params["CD4"].Sample(rng);
-      idv->kgamma = params["kGamma"].Sample(rng);
+      idv->initialCD4 = params.Sample(ParamID::CD4, rng);
+      idv->kgamma = params.Sample(ParamID::kGamma, rng);
       idv->t_HIV_infection = t;
       idv->hivDiagnosed = false;
 
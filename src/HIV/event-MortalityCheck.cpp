@@ -26,9 +26,9 @@ EventFunc TBABM::MortalityCheck(weak_p<Individual> idv_w)
         return true;
 
       // Retrieve constant parameters m, p, and m_30
-      double m = params["HIV_m"].Sample(rng);
-      double p = params["HIV_p"].Sample(rng);
-      double m_30 = params["HIV_m_30"].Sample(rng);
+      double m = params.Sample(ParamID::HIV_m, rng);
+      double p = params.Sample(ParamID::HIV_p, rng);
+      double m_30 = params.Sample(ParamID::HIV_m_30, rng);
 
       // Calculate current CD4 count
       double CD4 = idv->CD4count(t, m_30);
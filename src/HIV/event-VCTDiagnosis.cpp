@@ -29,13 +29,13 @@ EventFunc TBABM::VCTDiagnosis(weak_p<Individual> idv_w)
       }
 
       // Get constant parameter m_30 and CD4
-      double m_30 = params["HIV_m_30"].Sample(rng);
+      double m_30 = params.Sample(ParamID::HIV_m_30, rng);
       double CD4  = idv->CD4count(t, m_30);
 
       // Retrieve a_t_i (varies by year and age group) and sig_i
       //   (varies by age group)
-      double a_t_i = fileData["HIV_a_t_i"].getValue(startYear+(int)t/365, 0, idv->age(t), rng);
-      double sig_i = fileData["HIV_sig_i"].getValue(0, 0, idv->age(t), rng);
+      double a_t_i = fileData[FrameID::HIV_a_t_i].getValue(startYear+(int)t/365, 0, idv->age(t), rng);
+      double sig_i = fileData[FrameID::HIV_sig_i].getValue(0, 0, idv->age(t), rng);
 
       // Calculate rate of diagnosis and time to diagnosis
       double D_c = a_t_i*exp(-1 * sig_i * CD4);
@@ -44,9 +44,9 @@ EventFunc TBABM::VCTDiagnosis(weak_p<Individual> idv_w)
 
       bool initiateART;
       if (idv->tb.GetTBStatus(t) == TBStatus::Infectious)
-        initiateART = fileData["HIV_p_art_tb"].getValue(0, 0, CD4, rng);
+        initiateART = fileData[FrameID::HIV_p_art_tb].getValue(0, 0, CD4, rng);
       else
-        initiateART = fileData["HIV_p_art"].getValue(0, 0, CD4, rng);
+        initiateART = fileData[FrameID::HIV_p_art].getValue(0, 0, CD4, rng);
 
       // printf("\tInitiateART: %d\n", (int)initiateART);
       // printf("\tCD4: %d\n", (int)idv->CD4count(t, m_30));
@@ -16,7 +16,7 @@ bool TBABM::ARTEligible(int t, weak_p<Individual> idv_w)
 
   int year      = constants["startYear"] + (int)t/365;
   bool coin     = Bernoulli(0.5)(rng.mt_); // Flip a fair coin
-  double m_30   = params["HIV_m_30"].Sample(rng);
+  double m_30   = params.Sample(ParamID::HIV_m_30, rng);
   int CD4       = idv->CD4count(t, m_30);
   bool pregnant = idv->pregnant;
 
@@ -47,14 +47,14 @@ EventFunc TBABM::HIVInfectionCheck(weak_p<Individual> idv_w)
       // profiles are the same, and are drawn from Excel Thembisa 4.1
       if (spouse && !spouse->dead && spouse->hivStatus == HIVStatus::Positive)
         p_getInfected_thembisa = \
-          fileData["HIV_risk_spouse"].getValue(currentYear, gender, age, rng);
+          fileData[FrameID::HIV_risk_spouse].getValue(currentYear, gender, age, rng);
       else
         p_getInfected_thembisa = \
-          fileData["HIV_risk"].getValue(currentYear, gender, age, rng);
+          fileData[FrameID::HIV_risk].getValue(currentYear, gender, age, rng);
 
       // "HIV_risk_attenuation" is a value between [0,1]
       p_getInfected = \
-        params["HIV_risk_attenuation"].Sample(rng) * \
+        params.Sample(ParamID::HIV_risk_attenuation, rng) * \
         p_getInfected_thembisa;
 
       getsInfected = Bernoulli(p_getInfected)(rng.mt_);
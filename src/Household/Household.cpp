@@ -61,25 +61,7 @@ void Household::AddIndividual(shared_p<Individual> idv, int t, HouseholdPosition
   if (idv->tb.GetTBStatus(t) == TBStatus::Infectious)
     nInfectiousTBIndivduals += 1;
 
-  idv->tb.SetHouseholdCallbacks(
-    [this, idv] (const int& t,
-                 Param& frac_screened,
-                 Param& frac_visited,
-                 RNG& rng) -> ContactTraceResult {
-      return ContactTrace(t, idv, frac_screened, frac_visited, rng);
-    },
-
-    [this, idv] (int t) -> void   { nInfectiousTBIndivduals += 1;
-                                    TriggerReeval(t, idv); },
-
-    [this]      (int)   -> void   { nInfectiousTBIndivduals -= 1; },
-
-    [this]      (void)  -> double { return ActiveTBPrevalence(); },
-
-    [this]      (TBStatus s)  -> double { return ContactActiveTBPrevalence(s); },
-    [this]      (int maxage, int t)->int { return infectiousIndividualsUnderAge(maxage, t); },
-    [this]      (int maxage, int t)->int { return individualsUnderAge(maxage, t); }
-  );
+  idv->tb.SetHousehold(hid);
 
   return;
 }
@@ -141,7 +123,7 @@ void Household::RemoveIndividual(weak_p<Individual> idv_w, int t) {
   if (idv->tb.GetTBStatus(t) == TBStatus::Infectious)
     nInfectiousTBIndivduals -= 1;
 
-  idv->tb.ResetHouseholdCallbacks();
+  idv->tb.ResetHousehold();
 
   return;
 }
@@ -296,10 +278,9 @@ extern CTraceType trace_kind;
 
 ContactTraceResult
 Household::ContactTrace(const int& t,
-                        const shared_p<Individual> idv,
-                        Param& frac_screened,
-                        Param& frac_visited,
-                        RNG& rng) {
+                        const TB* index,
+                        const Draw& screened,
+                        const Draw& visited) {
 
   ContactTraceResult result;
 
@@ -318,7 +299,7 @@ Household::ContactTrace(const int& t,
     return result;
 
   if (n_contact_traces == 0)
-    can_trace = frac_visited.Sample(rng);
+    can_trace = visited();
 
   // Determine whether the house is "reachable." Note that, as implemented,
   // the concept of reachability applies to ALL contact-tracing scenarios.
@@ -328,7 +309,7 @@ Household::ContactTrace(const int& t,
   n_contact_traces += 1;
   result.did_visit  = true;
 
-  if (head && head != idv && !head->dead && frac_screened.Sample(rng)) {
+  if (head && &head->tb != index && !head->dead && screened()) {
     result.screenings += 1;
     result.screenings_hiv += head->hivStatus == HIVStatus::Positive  ? 1 : 0;
     result.screenings_children += head->age(t) < 5                   ? 1 : 0;
@@ -339,7 +320,7 @@ Household::ContactTrace(const int& t,
     result.cases_found_children += positive && head->age(t) < 5                  ? 1 : 0;
   }
 
-  if (spouse && spouse != idv && !spouse->dead && frac_screened.Sample(rng)) {
+  if (spouse && &spouse->tb != index && !spouse->dead && screened()) {
     result.screenings += 1;
     result.screenings_hiv += spouse->hivStatus == HIVStatus::Positive  ? 1 : 0;
     result.screenings_children += spouse->age(t) < 5                   ? 1 : 0;
@@ -352,7 +333,7 @@ Household::ContactTrace(const int& t,
 
   for (auto it = offspring.begin(); it != offspring.end(); it++) {
     assert(*it);
-    if (*it && *it != idv && !(*it)->dead && frac_screened.Sample(rng)) {
+    if (*it && &(*it)->tb != index && !(*it)->dead && screened()) {
       result.screenings += 1;
       result.screenings_hiv += (*it)->hivStatus == HIVStatus::Positive  ? 1 : 0;
       result.screenings_children += (*it)->age(t) < 5                   ? 1 : 0;
@@ -366,7 +347,7 @@ Household::ContactTrace(const int& t,
 
   for (auto it = other.begin(); it != other.end(); it++) {
     assert(*it);
-    if (*it && *it != idv && !(*it)->dead && frac_screened.Sample(rng)) {
+    if (*it && &(*it)->tb != index && !(*it)->dead && screened()) {
       result.screenings += 1;
       result.screenings_hiv += (*it)->hivStatus == HIVStatus::Positive  ? 1 : 0;
       result.screenings_children += (*it)->age(t) < 5                   ? 1 : 0;
@@ -381,24 +362,72 @@ Household::ContactTrace(const int& t,
   return result;
 }
 
-void Household::TriggerReeval(int t, weak_p<Individual> idv_w) {
-  auto idv = idv_w.lock();
-  if (!idv)
-    return;
+void Household::TBProgression(int t, const TB* index) {
+  nInfectiousTBIndivduals += 1;
+  TriggerReeval(t, index);
+}
+
+void Household::TBRecovery(int t) {
+  nInfectiousTBIndivduals -= 1;
+}
 
-  if (head && head != idv)
+void Household::TriggerReeval(int t, const TB* index) {
+  if (head && &head->tb != index)
     head->tb.RiskReeval(t);
 
-  if (spouse && spouse != idv)
+  if (spouse && &spouse->tb != index)
     spouse->tb.RiskReeval(t);
 
   for (auto person : offspring)
-    if (person && person != idv)
+    if (person && &person->tb != index)
       person->tb.RiskReeval(t);
 
   for (auto person : other)
-    if (person && person != idv)
+    if (person && &person->tb != index)
       person->tb.RiskReeval(t);
 
   return;
 }
+
+ContactTraceResult
+HouseholdService::ContactTrace(long hid,
+                               const int& t,
+                               const TB* index,
+                               const Household::Draw& screened,
+                               const Household::Draw& visited) {
+  if (auto hh = Lookup(hid))
+    return hh->ContactTrace(t, index, screened, visited);
+
+  ContactTraceResult result {};
+  return result;
+}
+
+void HouseholdService::TBProgression(long hid, int t, const TB* index) {
+  if (auto hh = Lookup(hid))
+    hh->TBProgression(t, index);
+}
+
+void HouseholdService::TBRecovery(long hid, int t) {
+  if (auto hh = Lookup(hid))
+    hh->TBRecovery(t);
+}
+
+double HouseholdService::ActiveTBPrevalence(long hid) {
+  auto hh = Lookup(hid);
+  return hh ? hh->ActiveTBPrevalence() : 0;
+}
+
+double HouseholdService::ContactActiveTBPrevalence(long hid, TBStatus s) {
+  auto hh = Lookup(hid);
+  return hh ? hh->ContactActiveTBPrevalence(s) : 0;
+}
+
+int HouseholdService::infectiousIndividualsUnderAge(long hid, int maxage, int t) {
+  auto hh = Lookup(hid);
+  return hh ? hh->infectiousIndividualsUnderAge(maxage, t) : 0;
+}
+
+int HouseholdService::individualsUnderAge(long hid, int maxage, int t) {
+  auto hh = Lookup(hid);
+  return hh ? hh->individualsUnderAge(maxage, t) : 0;
+}
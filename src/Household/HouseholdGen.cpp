@@ -10,28 +10,30 @@ HouseholdGen::GetHousehold(const int current_time, const int hid, RNG& rng)
   // Create a blank Household object
   auto household = std::make_shared<Household>(current_time, hid);
 
-  // Retrieve the corresponding vector
+  // Retrieve the corresponding family
   size_t size = families.size();
   size_t idx = rng.mt_() % size;
-  MicroFamily family = families[idx];
+  auto family = families[idx];
 
   // The first element in the vector is the head of the
   //   household; create an Individual using the smaller
   //   constructor
-  MicroIndividual _head = family[0];
+  auto _head = family[0];
 
   auto initSimContext = CreateIndividualSimContext(current_time, 
       event_queue, 
       rng,
       fileData,
-      params
+      params,
+      households,
+      agents
   );
 
   auto head = makeIndividual(
       initSimContext,
       masterData,
       initHandles,
-      name_gen.getName(rng), 
+      Names::getName(rng), 
       hid, 
       0-365*_head.age, 
       _head.sex, 
@@ -49,12 +51,12 @@ HouseholdGen::GetHousehold(const int current_time, const int hid, RNG& rng)
   // Return the household
   for (int i = 1; i < family.size(); ++i)
   {
-    MicroIndividual midv = family[i];
+    auto midv = family[i];
     auto idv = makeIndividual(
         initSimContext,
         masterData,
         initHandles,
-        name_gen.getName(rng), 
+        Names::getName(rng), 
         hid, 
         0-365*midv.age, 
         midv.sex, 
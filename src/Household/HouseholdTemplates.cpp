@@ -0,0 +1,218 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../include/TBABM/HouseholdTemplates.h"
+
+const char HouseholdTemplates::Magic[8] = {'T','B','A','B','M','H','H','1'};
+
+namespace {
+
+[[noreturn]] void Malformed(const char *file, const std::string& reason)
+{
+  throw std::runtime_error("household templates '" + std::string(file) + \
+                           "' are malformed: " + reason);
+}
+
+} // namespace
+
+HouseholdTemplates::HouseholdTemplates(const char *file)
+{
+  if (!Map(file))
+    ParseCSV(file);
+}
+
+HouseholdTemplates::~HouseholdTemplates(void)
+{
+  if (mapping)
+    munmap(mapping, mapping_size);
+}
+
+// Returns false, having changed nothing, if 'file' isn't a compiled
+// template file. Throws, having changed nothing, if it is one, but is
+// malformed.
+bool
+HouseholdTemplates::Map(const char *file)
+{
+  int fd = open(file, O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  Header h;
+  struct stat buf;
+
+  if (read(fd, &h, sizeof(h)) != sizeof(h) || \
+      memcmp(h.magic, Magic, sizeof(Magic)) != 0 || \
+      fstat(fd, &buf) != 0) {
+    close(fd);
+    return false;
+  }
+
+  std::size_t expected = sizeof(Header) + \
+                         sizeof(std::uint32_t) * (h.n_families + 1) + \
+                         sizeof(std::uint8_t)  * h.n_members * 2 + \
+                         sizeof(std::int16_t)  * h.n_members;
+
+  // HouseholdGen draws one of the households, and starts from its first
+  // member, so there must be a household, and each must have someone in it
+  if (h.n_families == 0) {
+    close(fd);
+    Malformed(file, "there are no households");
+  }
+
+  if (static_cast<std::size_t>(buf.st_size) != expected) {
+    close(fd);
+    Malformed(file, std::to_string(buf.st_size) + " bytes, expected " + \
+                    std::to_string(expected));
+  }
+
+  void *p = mmap(nullptr, expected, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (p == MAP_FAILED)
+    throw std::runtime_error("could not map household templates '" + std::string(file) + "'");
+
+  auto base = static_cast<const char *>(p) + sizeof(Header);
+
+  auto o  = reinterpret_cast<const std::uint32_t *>(base);
+  base   += sizeof(std::uint32_t) * (h.n_families + 1);
+  auto r  = reinterpret_cast<const std::uint8_t *>(base);
+  base   += h.n_members;
+  auto s  = reinterpret_cast<const std::uint8_t *>(base);
+  base   += h.n_members;
+  auto a  = reinterpret_cast<const std::int16_t *>(base);
+
+  const char *malformed {nullptr};
+
+  if (o[0] != 0 || o[h.n_families] != h.n_members)
+    malformed = "offsets don't span the members";
+
+  for (std::uint32_t i = 0; !malformed && i < h.n_families; i++)
+    if (o[i] >= o[i+1])
+      malformed = o[i] == o[i+1] ? "a household has no members" : "offsets decrease";
+
+  if (malformed) {
+    munmap(p, expected);
+    Malformed(file, malformed);
+  }
+
+  mapping      = p;
+  mapping_size = expected;
+  n_families   = h.n_families;
+  n_members    = h.n_members;
+
+  offsets = o;
+  roles   = r;
+  sexes   = s;
+  ages    = a;
+
+  return true;
+}
+
+void
+HouseholdTemplates::ParseCSV(const char *file)
+{
+  FILE *ifile = fopen(file, "r");
+  int c;
+  int lines = 2;
+
+  if (!ifile)
+    throw std::runtime_error("could not open households file '" + std::string(file) + "'");
+
+  offsets_v.push_back(0);
+
+  // Skip first two lines
+  while ((c = getc(ifile)) != EOF && c != '\n');
+  while ((c = getc(ifile)) != EOF && c != '\n');
+
+  while (!feof(ifile)) {
+    lines++;
+
+    fscanf(ifile, "%i", &c);
+    if (getc(ifile) != ',') {
+      std::cerr << "Line #" << lines << " has a noninteger number of people. Skipping over" << std::endl;
+      while ((c = getc(ifile)) != EOF && c != '\n');
+      continue;
+    }
+
+    if (c < 1) {
+      std::cerr << "Line #" << lines << " has nobody in it. Skipping over" << std::endl;
+      while ((c = getc(ifile)) != EOF && c != '\n');
+      continue;
+    }
+
+    while (c--) {
+      int r, s; // Hold temporary values
+
+      HouseholdPosition role;
+      Sex sex;
+      int age;
+
+      fscanf(ifile, "%i,%i,%i,", &r, &s, &age);
+
+      switch (r) {
+        case (1):  role = HouseholdPosition::Head; break;
+        case (2):  role = HouseholdPosition::Spouse; break;
+        case (3):  role = HouseholdPosition::Offspring; break;
+        case (4):  role = HouseholdPosition::Offspring; break;
+        default:   role = HouseholdPosition::Other;
+      }
+
+      switch (s) {
+        case(1): sex = Sex::Male;   break;
+        case(2): sex = Sex::Female; break;
+        default: sex = Sex::Male;
+      }
+
+      roles_v.push_back(static_cast<std::uint8_t>(role));
+      sexes_v.push_back(static_cast<std::uint8_t>(sex));
+      ages_v.push_back(static_cast<std::int16_t>(age));
+    }
+
+    int b;
+    while((b = getc(ifile)) != EOF && b != '\n');
+    offsets_v.push_back(static_cast<std::uint32_t>(roles_v.size()));
+  }
+
+  fclose(ifile);
+
+  if (offsets_v.size() < 2)
+    throw std::runtime_error("households file '" + std::string(file) + "' has no households");
+
+  n_families = static_cast<std::uint32_t>(offsets_v.size() - 1);
+  n_members  = static_cast<std::uint32_t>(roles_v.size());
+
+  offsets = offsets_v.data();
+  roles   = roles_v.data();
+  sexes   = sexes_v.data();
+  ages    = ages_v.data();
+}
+
+bool
+HouseholdTemplates::Write(const char *file) const
+{
+  FILE *ofile = fopen(file, "wb");
+  if (!ofile)
+    return false;
+
+  Header h;
+  memcpy(h.magic, Magic, sizeof(Magic));
+  h.n_families = n_families;
+  h.n_members  = n_members;
+
+  bool ok = fwrite(&h, sizeof(h), 1, ofile) == 1 && \
+            fwrite(offsets, sizeof(*offsets), n_families + 1, ofile) == n_families + 1 && \
+            fwrite(roles, sizeof(*roles), n_members, ofile) == n_members && \
+            fwrite(sexes, sizeof(*sexes), n_members, ofile) == n_members && \
+            fwrite(ages,  sizeof(*ages),  n_members, ofile) == n_members;
+
+  return fclose(ofile) == 0 && ok;
+}
@@ -14,14 +14,18 @@ CreateIndividualHandlers(function<void(weak_p<Individual>, int, DeathCause)> Dea
 CreateIndividualSimContext(int current_time, 
     EQ& event_queue, 
     RNG& rng,
-    map<string, DataFrameFile>& fileData,
-    Params& params)
+    const FrameTable& fileData,
+    ParamTable& params,
+    HouseholdService& households,
+    AgentRegistry& agents)
 {
   return {
     current_time, 
     event_queue, 
     rng,
     fileData,
-    params
+    params,
+    households,
+    agents
   };
 }
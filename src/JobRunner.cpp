@@ -0,0 +1,552 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+
+#include "../include/TBABM/JobRunner.h"
+#include "../include/TBABM/Checkpoint.h"
+#include "../include/TBABM/Shards.h"
+#include "../include/TBABM/SQLiteOutputs.h"
+
+// Survey rows are streamed to the writer in blocks of this many bytes as
+// trajectories run, so that they don't pile up either
+static const std::size_t survey_block {1 << 20};
+
+// Mean seconds taken by a trajectory of 'key', according to the timings
+// file 'fname' (lines of 'key,seconds'). Negative if it has none.
+static double priorSeconds(const string& fname, const string& key)
+{
+  std::ifstream in(fname);
+  string line;
+
+  double total {0};
+  int n {0};
+
+  while (std::getline(in, line)) {
+    auto comma = line.rfind(',');
+    if (comma == string::npos || line.compare(0, comma, key) != 0 || comma != key.size())
+      continue;
+
+    total += atof(line.c_str() + comma + 1);
+    n++;
+  }
+
+  return n > 0 ? total / n : -1;
+}
+
+static void recordSeconds(const string& fname, const string& key, const std::vector<double>& seconds)
+{
+  std::ofstream out(fname, std::ios_base::app);
+
+  for (auto s : seconds)
+    if (s >= 0)
+      out << key << ',' << s << '\n';
+}
+
+// A job whose trajectories are on the pool. Under --adaptive, how many
+// trajectories it runs is decided as they finish, so its counts are kept
+// under 'mutex'. Trajectories are launched ahead of that decision to keep
+// the pool busy, and their results held until every trajectory before
+// them has finished: the stopping rule sees them in seed order, so where
+// it stops doesn't depend on the pool's size or timing.
+struct JobRunner::Job : JobRunner::JobSpec {
+  explicit Job(JobSpec&& spec) : JobSpec(std::move(spec)) {};
+
+  std::int64_t run {-1};  // In the database, once the writer records it
+
+  std::mutex mutex;
+  std::condition_variable joined;
+  int launched {0};
+  int completed {0};
+  int kept {0};           // Trajectories 0..kept-1 go to its outputs
+  int exported {0};
+  int failed {0};
+  bool closed {false};    // No more trajectories will be launched, or kept
+  std::vector<int> status; // Of each trajectory: -1 running, 0 failed,
+                           // 1 ok, 2 run by another worker process,
+                           // 3 restored from the checkpoint
+  std::vector<double> seconds;
+  TargetStats stats {0};  // Of trajectories 0..kept-1
+
+  // Under --adaptive, the results and target values of trajectories
+  // that finished before one ahead of them did
+  std::map<int, std::pair<std::unique_ptr<TrajectoryResult>, std::vector<double>>> held;
+};
+
+JobRunner::JobRunner(const Options& options,
+                     Checkpoint *checkpoint,
+                     SQLiteOutputs *database,
+                     Shards *shards,
+                     Report report,
+                     std::shared_ptr<RunOutputs> combined,
+                     const string& prefix) :
+  options(options),
+  checkpoint(checkpoint),
+  database(database),
+  shards(shards),
+  report(report),
+  combined(combined),
+  prefix(prefix),
+  memory(options.memory_budget, options.bytes_per_agent_year),
+  pool(new WorkStealingPool(options.pool_size, options.pin, options.first_cpu)),
+  finished(2 * options.pool_size)
+{
+  if (options.jobs_csv != "") {
+    jobs_file.open(options.jobs_csv);
+    jobs_file << "runsheet,spec,trajectory" << std::endl;
+  }
+
+  writer   = std::thread([this] { write(); });
+  admitter = std::thread([this] { admit(); });
+}
+
+JobRunner::~JobRunner(void)
+{
+  if (writer.joinable())
+    Finish();
+}
+
+void JobRunner::write(void)
+{
+  for (;;) {
+    Finished f;
+    finished.Pop(f);
+
+    if (!f.job)
+      return;
+
+    auto& job = *f.job;
+    bool exported {false};
+
+    if (database && job.run < 0)
+      job.run = database->AddRun(job.id, job.spec, job.seed, job.sheet);
+
+    if (!f.rows.empty()) {
+      if (!job.outputs->AddSurveyRows(f.survey, f.rows))
+        export_failed = true;
+
+      continue;
+    }
+
+    // The result is handed over, so that its series needn't be copied
+    bool ran {f.result != nullptr};
+
+    if (ran)
+      exported = checkpoint ? checkpoint->Save(job.id, f.i, std::move(f.result), f.values)
+                            : job.outputs->Add(std::move(f.result));
+    else if (checkpoint)
+      checkpoint->Abandon(job.id, f.i);
+
+    if (ran && !exported) {
+      printf("Trajectory #%4d: ExportTrajectrory(1) failed\n", f.i);
+      export_failed = true;
+    }
+
+    if (database && !database->AddTrajectory(job.run, job.seeds[f.i], exported))
+      export_failed = true;
+
+    int trajectories;
+
+    {
+      std::lock_guard<std::mutex> lock(job.mutex);
+
+      if (!exported && job.status[f.i] < 2)
+        job.failed++;
+
+      job.exported++;
+
+      if (!job.closed || job.exported < job.kept)
+        continue;
+
+      trajectories = job.kept;
+    }
+
+    if (!job.outputs || job.outputs == combined)
+      continue;
+
+    // A worker process that ran none of a job's trajectories leaves its
+    // outputs to the others
+    bool written = job.outputs->Added() == 0 && shards ? true : job.outputs->Write();
+
+    if (written && database)
+      written = database->Load(job.prefix, job.run);
+
+    // A worker process's outputs are made columnar once they're merged
+    if (written && options.columnar && !shards)
+      written = RunOutputs::ToColumnar(job.prefix);
+
+    if (!written) {
+      printf("WriteData() failed for job %s\n", job.id.c_str());
+      export_failed = true;
+    }
+
+    report({{"id",           job.id},
+            {"status",       written && job.failed == 0 ? "ok" : "failed"},
+            {"output",       job.prefix},
+            {"trajectories", trajectories},
+            {"failed",       job.failed}});
+
+    job.outputs.reset();
+  }
+}
+
+namespace {
+
+// What a trajectory of 'model' is expected to take, for MemoryBudget
+double Agents(const Model& model) { return model.GetConstants().at("populationSize"); }
+double Years(const Model& model)  { return model.GetConstants().at("tMax") / 365.; }
+
+} // namespace
+
+// Queues trajectory 'i' of 'job' to start once it fits in memory. As each
+// finishes, an adaptive job that hasn't converged starts another in its
+// place.
+void JobRunner::launch(std::shared_ptr<Job> job, int i)
+{
+  {
+    std::lock_guard<std::mutex> lock(admission_mutex);
+    wait(job, i);
+  }
+
+  admission.notify_one();
+}
+
+// With 'admission_mutex' held
+void JobRunner::wait(std::shared_ptr<Job> job, int i)
+{
+  // Those a checkpointed run was stopped in the middle of go first
+  double cost {checkpoint && checkpoint->Interrupted(job->id, i) ? 2 * job->cost : job->cost};
+
+  waiting.emplace(cost, std::make_pair(job, i));
+}
+
+// Hands waiting trajectories to the pool, costliest first, as they fit in
+// memory. One that doesn't fit waits here, not on a pool thread, and those
+// behind it that do fit go ahead of it.
+void JobRunner::admit(void)
+{
+  std::unique_lock<std::mutex> lock(admission_mutex);
+
+  for (;;) {
+    admission.wait(lock, [this] { return stopping || !waiting.empty(); });
+
+    if (waiting.empty())
+      return;
+
+    auto it = waiting.begin();
+    while (it != waiting.end() && \
+           !memory.TryAdmit(Agents(*it->second.first->model), Years(*it->second.first->model)))
+      ++it;
+
+    if (it == waiting.end()) {
+      lock.unlock();
+      memory.Wait();
+      lock.lock();
+      continue;
+    }
+
+    auto job  = it->second.first;
+    int i     = it->second.second;
+    auto cost = it->first;
+
+    waiting.erase(it);
+
+    lock.unlock();
+    run(job, i, cost);
+    lock.lock();
+  }
+}
+
+// Starts trajectory 'i' of 'job', admitted to memory, on the pool
+void JobRunner::run(std::shared_ptr<Job> job, int i, double cost)
+{
+  pool->enqueue(cost, [this, job, i] {
+    auto& targets = options.targets;
+    auto& constants = job->model->GetConstants();
+
+    double agents {Agents(*job->model)};
+    double years  {Years(*job->model)};
+
+    // Another worker process got here first
+    if (shards && !shards->Claim(job->first_item + i)) {
+      memory.Release(agents, years);
+
+      std::lock_guard<std::mutex> lock(job->mutex);
+
+      job->completed++;
+      job->status[i] = 2;
+
+      if (job->closed && job->completed == job->launched)
+        job->joined.notify_all();
+
+      finished.Push(Finished{job, i, nullptr});
+      return false;
+    }
+
+    // Past where an adaptive job stopped, there is nothing to run for
+    {
+      std::lock_guard<std::mutex> lock(job->mutex);
+
+      if (job->closed && i >= job->kept) {
+        memory.Release(agents, years);
+
+        job->completed++;
+
+        if (job->completed == job->launched)
+          job->joined.notify_all();
+
+        return false;
+      }
+    }
+
+    // A trajectory saved by an earlier run that was killed isn't run
+    // again; its outputs are already in the checkpoint
+    std::vector<double> values {};
+    bool restored = checkpoint && checkpoint->Restore(job->id, i, values);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::unique_ptr<TrajectoryResult> result;
+
+    if (restored) {
+      memory.Release(agents, years);
+      printf("#%4d RESTORED\n", i);
+    }
+    else {
+      printf("#%4d RUNNING\n", i);
+
+      if (checkpoint)
+        checkpoint->Started(job->id, i, job->seeds[i]);
+
+      // A checkpoint saves a trajectory whole, so it keeps its surveys
+      // until it finishes; so does an adaptive job, which may leave the
+      // trajectory out
+      SurveySink surveys {};
+      if (!checkpoint && targets.empty())
+        surveys = [this, job, i] (SurveyKind survey, string&& rows) {
+          finished.Push(Finished{job, i, nullptr, {}, survey, std::move(rows)});
+        };
+
+      // Run the trajectory and check its' status
+      if (!(result = job->model->Run(job->seeds[i], surveys, survey_block)))
+        printf("Trajectory %4d: Run() failed\n", i);
+
+      memory.Release(agents, years);
+    }
+
+    if (result)
+      for (auto&& target : targets)
+        values.push_back(Evaluate(target, result->data,
+                                  constants.at("startYear"),
+                                  constants.at("periodLength")));
+
+    bool ok {restored || (bool)result};
+    int next {-1};
+
+    // To the writer, in seed order under --adaptive
+    std::vector<Finished> ready {};
+
+    {
+      std::lock_guard<std::mutex> lock(job->mutex);
+
+      job->completed++;
+      job->status[i] = restored ? 3 : result ? 1 : 0;
+
+      if (!restored)
+        job->seconds[i] = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start).count();
+
+      if (targets.empty())
+        ready.push_back(Finished{job, i, std::move(result), std::move(values)});
+      else if (!job->closed) {
+        job->held[i] = std::make_pair(std::move(result), std::move(values));
+
+        // Each trajectory whose predecessors have all finished is added
+        // to the statistics, and the stopping rule applied
+        for (auto it = job->held.find(job->kept); !job->closed && it != job->held.end();
+             it = job->held.find(job->kept)) {
+          if (it->second.second.size() == targets.size())
+            job->stats.Add(it->second.second);
+
+          ready.push_back(Finished{job, it->first, std::move(it->second.first),
+                                   std::move(it->second.second)});
+          job->held.erase(it);
+          job->kept++;
+
+          bool converged = job->stats.Count() >= options.min_trajectories && \
+                           job->stats.Converged(options.tolerance, options.relative_tolerance);
+
+          if (converged || job->kept == static_cast<int>(job->seeds.size())) {
+            job->closed = true;
+            printf("Job %s: %s after %d trajectories\n", job->id.c_str(),
+                   converged ? "converged" : "stopped at the maximum", job->kept);
+          }
+        }
+
+        // Those past where it stopped are left out
+        if (job->closed)
+          job->held.clear();
+        else if (job->launched < static_cast<int>(job->seeds.size()))
+          next = job->launched++;
+      }
+
+      if (job->closed && job->completed == job->launched)
+        job->joined.notify_all();
+    }
+
+    if (next >= 0)
+      launch(job, next);
+
+    for (auto&& f : ready)
+      finished.Push(std::move(f));
+
+    return ok;
+  });
+}
+
+// Waits for the oldest job in flight to finish, and takes it off the pool
+void JobRunner::join(void)
+{
+  auto& job = *in_flight.front();
+  auto& targets = options.targets;
+  bool listed {jobs_file.is_open()};
+
+  // Barrier: Wait for each trajectory to return successfully or unsuccessfully
+  std::unique_lock<std::mutex> lock(job.mutex);
+  job.joined.wait(lock, [&job] { return job.closed && job.completed == job.launched; });
+
+  for (int i = 0; i < job.kept; i++) {
+    if (job.status[i] == 2)
+      continue;
+    else if (listed)
+      printf("%s #%4d JOINED: %d\n", job.id.c_str(), i, job.status[i]);
+    else
+      printf("#%4d JOINED: %d\n", i, job.status[i]);
+  }
+
+  for (std::size_t k = 0; k < targets.size(); k++)
+    printf("%s: %g (standard error %g, %d trajectories)\n",
+           targets[k].spec.c_str(), job.stats.Mean(k), job.stats.SE(k), job.stats.Count());
+
+  if (listed) {
+    for (int i = 0; i < job.kept; i++)
+      if (job.status[i] != 2)
+        jobs_file << job.id << ",\"" << job.spec << "\"," << job.seeds[i] << '\n';
+    jobs_file.flush();
+  }
+
+  if (options.timings_file != "")
+    recordSeconds(options.timings_file, job.timings_key, job.seconds);
+
+  if (checkpoint)
+    to_merge.emplace_back(job.id, job.prefix, job.kept);
+
+  lock.unlock();
+  in_flight.pop_front();
+}
+
+void JobRunner::Submit(JobSpec&& spec)
+{
+  auto job = std::make_shared<Job>(std::move(spec));
+  auto& targets = options.targets;
+
+  // Trajectories are ordered longest-expected-first, by how long this
+  // runsheet's took before if that is known
+  if (options.timings_file != "") {
+    double prior = priorSeconds(options.timings_file, job->timings_key);
+    if (prior >= 0)
+      job->cost = prior;
+  }
+
+  int trajectories = static_cast<int>(job->seeds.size());
+
+  job->status.assign(trajectories, -1);
+  job->seconds.assign(trajectories, -1);
+  job->stats = TargetStats(targets.size());
+
+  // An adaptive job starts with enough trajectories to fill the pool,
+  // and at least --min-trajectories. How many it keeps is decided as
+  // they finish.
+  job->launched = targets.empty() ? trajectories : \
+                  std::min(trajectories, std::max(options.min_trajectories, options.pool_size));
+  job->closed   = targets.empty();
+  job->kept     = targets.empty() ? trajectories : 0;
+
+  // Make room on the pool before adding to it
+  while (in_flight.size() >= static_cast<std::size_t>(options.lookahead))
+    join();
+
+  // Queued together, so that the admitter sees them all, and starts the
+  // costliest first
+  {
+    std::lock_guard<std::mutex> lock(admission_mutex);
+
+    for (int i = 0; i < job->launched; i++)
+      wait(job, i);
+  }
+
+  admission.notify_one();
+
+  in_flight.push_back(job);
+}
+
+bool JobRunner::Finish(void)
+{
+  while (!in_flight.empty())
+    join();
+
+  std::cout << std::endl;
+
+  // Nothing is left waiting for memory
+  {
+    std::lock_guard<std::mutex> lock(admission_mutex);
+    stopping = true;
+  }
+
+  admission.notify_one();
+  admitter.join();
+
+  // A task may still be handing its results over after its job is joined
+  pool.reset();
+
+  // Every result is queued by now; let the writer drain them, then stop
+  finished.Push(Finished{nullptr, -1, nullptr});
+  writer.join();
+
+  if (combined && !(shards && combined->Added() == 0) && !combined->Write())
+    export_failed = true;
+
+  if (combined && database && !export_failed && !database->Load(prefix))
+    export_failed = true;
+
+  if (combined && options.columnar && !shards && !export_failed && \
+      !RunOutputs::ToColumnar(prefix))
+    export_failed = true;
+
+  // A checkpoint that is missing a trajectory is kept, so that running
+  // again retries it
+  if (checkpoint && !export_failed) {
+    bool merged {true};
+
+    std::set<string> prefixes {};
+
+    for (auto&& m : to_merge) {
+      merged &= checkpoint->Merge(std::get<0>(m), std::get<1>(m), std::get<2>(m));
+      prefixes.insert(std::get<1>(m));
+    }
+
+    if (merged && options.columnar)
+      for (auto&& prefix : prefixes)
+        merged &= RunOutputs::ToColumnar(prefix);
+
+    if (merged)
+      checkpoint->Remove();
+    else
+      export_failed = true;
+  }
+
+  return !export_failed;
+}
@@ -0,0 +1,220 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+#include "../include/TBABM/JobSource.h"
+#include "../include/TBABM/RunsheetBundle.h"
+#include "../include/TBABM/Sweep.h"
+
+using namespace SimulationLib::JSONImport;
+
+namespace {
+
+// True if the file a spec names exists; a bundle selector's '#k' is ignored
+bool specExists(const string& spec)
+{
+  string file {spec};
+  std::uint32_t k;
+  struct stat buf;
+
+  RunsheetBundle::ParseSelector(spec, file, k);
+
+  return stat(file.c_str(), &buf) == 0;
+}
+
+} // namespace
+
+json
+LoadRunsheet(const string& spec)
+{
+  static std::unique_ptr<RunsheetBundle> bundle;
+  static string bundle_open;
+
+  string bundle_file;
+  std::uint32_t bundle_run;
+
+  if (RunsheetBundle::ParseSelector(spec, bundle_file, bundle_run)) {
+    if (!bundle || bundle_open != bundle_file) {
+      bundle.reset(new RunsheetBundle(bundle_file.c_str()));
+      bundle_open = bundle_file;
+    }
+
+    return bundle->Runsheet(bundle_run);
+  }
+
+  auto is_csv = spec.size() > 4 && \
+                spec.compare(spec.size() - 4, 4, ".csv") == 0;
+
+  return is_csv ? Sweep::ReadRunsheetCSV(spec.c_str()) : fileToJSON(spec);
+}
+
+bool
+LoadRunsheet(const JobRequest& request, json& sheet, string& error)
+{
+  try {
+    sheet = request.sheet.is_null() ? LoadRunsheet(request.spec) : request.sheet;
+  }
+  catch (const std::exception& e) {
+    error = "could not read runsheet '" + request.spec + "': " + e.what();
+    return false;
+  }
+
+  if (request.set.is_null())
+    return true;
+
+  for (auto it = request.set.begin(); it != request.set.end(); ++it)
+    if (!RunsheetBundle::Substitute(sheet, it.key(), it.value().get<double>())) {
+      error = "'" + it.key() + "' is not in the runsheet";
+      return false;
+    }
+
+  return true;
+}
+
+JobSource::JobSource(const string& file, bool resident) :
+  file(file), resident(resident)
+{
+  if (file == "-")
+    return;
+
+  struct stat buf;
+  fifo = stat(file.c_str(), &buf) == 0 && S_ISFIFO(buf.st_mode);
+
+  // Opening a FIFO blocks until something opens it to write
+  owned.reset(new std::ifstream(file));
+
+  if (owned->fail()) {
+    printf("Error: could not open job file '%s'\n", file.c_str());
+    exit(EXIT_FAILURE);
+  }
+}
+
+bool
+JobSource::ReadLine(string& line)
+{
+  for (;;) {
+    std::istream& in = owned ? *owned : std::cin;
+
+    if (std::getline(in, line))
+      return true;
+
+    if (!(resident && fifo))
+      return false;
+
+    // Every writer has closed the FIFO. Wait for the next one.
+    owned.reset(new std::ifstream(file));
+
+    if (owned->fail()) {
+      printf("Error: could not reopen job file '%s'\n", file.c_str());
+      return false;
+    }
+  }
+}
+
+bool
+JobSource::Next(JobRequest& request)
+{
+  request = JobRequest {};
+
+  if (bundle_next < bundle_runs) {
+    request.spec = bundle_file + "#" + std::to_string(bundle_next++);
+    return true;
+  }
+
+  string line;
+
+  for (;;) {
+    if (!ReadLine(line))
+      return false;
+
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+      line.pop_back();
+
+    if (!line.empty() && line[0] != '#')
+      break;
+  }
+
+  if (line[0] != '{') {
+    if (line.find('#') == string::npos && RunsheetBundle::IsBundle(line.c_str())) {
+      try {
+        bundle_runs = RunsheetBundle(line.c_str()).Runs();
+      }
+      catch (const std::runtime_error& e) {
+        request.spec  = line;
+        request.error = e.what();
+        return true;
+      }
+
+      bundle_file = line;
+      bundle_next = 0;
+
+      return Next(request);
+    }
+
+    request.spec = line;
+
+    if (!specExists(request.spec))
+      request.error = "no such runsheet '" + request.spec + "'";
+
+    return true;
+  }
+
+  json d = json::parse(line, nullptr, false);
+
+  if (d.is_discarded() || !d.is_object()) {
+    request.error = "not a JSON object";
+    return true;
+  }
+
+  if (d.count("id"))
+    request.id = d["id"].is_string() ? d["id"].get<string>() : d["id"].dump();
+
+  auto& runsheet = d["runsheet"];
+
+  if (runsheet.is_string()) {
+    request.spec = runsheet.get<string>();
+    if (!specExists(request.spec))
+      request.error = "no such runsheet '" + request.spec + "'";
+  } else if (runsheet.is_array())
+    request.sheet = runsheet;
+  else
+    request.error = "\"runsheet\" must be a path, or an array of rows";
+
+  if (d.count("set")) {
+    request.set = d["set"];
+
+    bool numeric = request.set.is_object();
+    for (auto&& v : request.set)
+      numeric = numeric && v.is_number();
+
+    if (!numeric)
+      request.error = "\"set\" must map short-names to numbers";
+  }
+
+  if (d.count("seed")) {
+    if (d["seed"].is_number_unsigned()) {
+      request.has_seed = true;
+      request.seed     = d["seed"].get<std::uint64_t>();
+    } else
+      request.error = "\"seed\" must be a non-negative integer";
+  }
+
+  if (d.count("trajectories")) {
+    if (d["trajectories"].is_number_unsigned() && d["trajectories"].get<int>() > 0)
+      request.trajectories = d["trajectories"].get<int>();
+    else
+      request.error = "\"trajectories\" must be a positive integer";
+  }
+
+  if (d.count("output")) {
+    if (d["output"].is_string())
+      request.output = d["output"].get<string>();
+    else
+      request.error = "\"output\" must be a path";
+  }
+
+  return true;
+}
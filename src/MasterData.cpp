@@ -156,3 +156,31 @@ MasterData::Close(void)
 
   return;
 }
+
+TimeSeries<int> *
+MasterData::Series(const std::string& name)
+{
+#define TBABM_SERIES(name_, member) \
+  if (name == #name_)               \
+    return &member;
+#define TBABM_PYRAMID(name_, member)
+#include "../include/TBABM/OutputNames.inc"
+#undef TBABM_PYRAMID
+#undef TBABM_SERIES
+
+  return nullptr;
+}
+
+PyramidTimeSeries *
+MasterData::Pyramid(const std::string& name)
+{
+#define TBABM_SERIES(name_, member)
+#define TBABM_PYRAMID(name_, member) \
+  if (name == #name_)                \
+    return &member;
+#include "../include/TBABM/OutputNames.inc"
+#undef TBABM_PYRAMID
+#undef TBABM_SERIES
+
+  return nullptr;
+}
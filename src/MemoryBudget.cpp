@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "../include/TBABM/MemoryBudget.h"
+
+namespace {
+
+// The number in the file 'fname', or 'none' if it can't be read (or, as
+// for a cgroup v2 limit of 'max', isn't a number)
+std::size_t readLimit(const string& fname, std::size_t none)
+{
+  std::ifstream in(fname);
+  unsigned long long limit;
+
+  return in >> limit ? static_cast<std::size_t>(limit) : none;
+}
+
+// The limit of the memory cgroup this process is in, if it has one
+std::size_t cgroupLimit(void)
+{
+  const auto none = std::numeric_limits<std::size_t>::max();
+
+  std::ifstream in("/proc/self/cgroup");
+  string line;
+  std::size_t limit {none};
+
+  // Lines are 'id:controllers:path'. cgroup v2 has one, '0::path'; v1 has
+  // one per hierarchy, and the limit is under the one for 'memory'.
+  while (std::getline(in, line)) {
+    auto first  = line.find(':');
+    auto second = line.find(':', first + 1);
+
+    if (first == string::npos || second == string::npos)
+      continue;
+
+    string controllers {line.substr(first + 1, second - first - 1)};
+    string path        {line.substr(second + 1)};
+
+    if (controllers == "")
+      limit = std::min(limit, readLimit("/sys/fs/cgroup" + path + "/memory.max", none));
+    else if (("," + controllers + ",").find(",memory,") != string::npos)
+      limit = std::min(limit, readLimit("/sys/fs/cgroup/memory" + path + "/memory.limit_in_bytes", none));
+  }
+
+  return limit;
+}
+
+std::size_t resourceLimit(int resource)
+{
+  struct rlimit r;
+
+  if (getrlimit(resource, &r) != 0 || r.rlim_cur == RLIM_INFINITY)
+    return std::numeric_limits<std::size_t>::max();
+
+  return static_cast<std::size_t>(r.rlim_cur);
+}
+
+} // namespace
+
+std::size_t
+MemoryBudget::Limit(void)
+{
+  std::size_t physical = static_cast<std::size_t>(sysconf(_SC_PHYS_PAGES)) * \
+                         static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+  return std::min({physical, cgroupLimit(), resourceLimit(RLIMIT_AS), resourceLimit(RLIMIT_DATA)});
+}
+
+std::size_t
+MemoryBudget::RSS(void)
+{
+  std::ifstream in("/proc/self/statm");
+  std::size_t size, resident;
+
+  if (!(in >> size >> resident))
+    return 0;
+
+  return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+std::size_t
+MemoryBudget::ParseSize(const string& size)
+{
+  char *end {nullptr};
+  double n = strtod(size.c_str(), &end);
+
+  switch (*end) {
+    case 'K': case 'k': n *= 1024.;                      end++; break;
+    case 'M': case 'm': n *= 1024. * 1024;               end++; break;
+    case 'G': case 'g': n *= 1024. * 1024 * 1024;        end++; break;
+    case 'T': case 't': n *= 1024. * 1024 * 1024 * 1024; end++; break;
+  }
+
+  if (end == size.c_str() || *end != '\0' || n < 0) {
+    printf("Error: malformed size '%s'\n", size.c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  return static_cast<std::size_t>(n);
+}
+
+MemoryBudget::MemoryBudget(std::size_t budget, double bytes_per_agent_year) :
+  budget(budget > 0 ? budget : Limit() / 10 * 9),
+  baseline(RSS()),
+  per_agent_year(bytes_per_agent_year),
+  prior(bytes_per_agent_year),
+  rss(baseline),
+  sampler(&MemoryBudget::monitor, this)
+{
+  printf("Memory budget: %.0f MB, of which %.0f MB is in use\n",
+         this->budget / 1048576., baseline / 1048576.);
+}
+
+MemoryBudget::~MemoryBudget(void)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+
+  changed.notify_all();
+  sampler.join();
+}
+
+bool
+MemoryBudget::fits(double agent_years) const
+{
+  if (admitted == 0)
+    return true;
+
+  return rss <= budget && \
+         baseline + (admitted_agent_years + agent_years) * per_agent_year <= budget;
+}
+
+bool
+MemoryBudget::TryAdmit(double agents, double years)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  double agent_years {agents * years};
+
+  if (!fits(agent_years)) {
+    if (!throttled)
+      printf("Memory: holding trajectories back with %d running (%.0f MB "
+             "resident, %.0f bytes per agent-year)\n", admitted, rss / 1048576., per_agent_year);
+
+    throttled = true;
+    return false;
+  }
+
+  throttled = false;
+  admitted++;
+  admitted_agent_years += agent_years;
+  peak_agent_years = std::max(peak_agent_years, admitted_agent_years);
+
+  return true;
+}
+
+void
+MemoryBudget::Wait(void)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+
+  if (!stop)
+    changed.wait(lock);
+}
+
+void
+MemoryBudget::Release(double agents, double years)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    admitted--;
+    admitted_agent_years -= agents * years;
+
+    // A trajectory has now been measured from start to finish, so the
+    // prior no longer stands
+    released = true;
+    per_agent_year = measured > 0 ? measured : per_agent_year;
+  }
+
+  changed.notify_all();
+}
+
+void
+MemoryBudget::monitor(void)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while (!stop) {
+    changed.wait_for(lock, std::chrono::milliseconds(100));
+
+    lock.unlock();
+    auto now = RSS();
+    lock.lock();
+
+    rss = now;
+
+    // Freed memory mostly stays resident, to be reused, so what is
+    // resident is compared with the most agent-years ever admitted at once
+    if (peak_agent_years > 0 && rss > baseline)
+      measured = std::max(measured, (rss - baseline) / peak_agent_years);
+
+    per_agent_year = released ? std::max(per_agent_year, measured) : std::max(prior, measured);
+
+    lock.unlock();
+    changed.notify_all();
+    lock.lock();
+  }
+}
@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <fstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/TBABM/MergeOutputs.h"
+
+namespace {
+
+// Moves (or, unless 'move', copies) the files under 'from' + 'rel' to
+// 'to' + 'rel', recursively. A file already in 'merged' is appended to
+// without its header line; any other replaces whatever is at its
+// destination.
+bool mergeDir(const string& from, const string& to, const string& rel,
+              std::set<string>& merged, bool move)
+{
+  DIR *dir = opendir((from + rel).c_str());
+  bool ok {true};
+
+  if (!dir) {
+    printf("Error: could not read '%s'\n", (from + rel).c_str());
+    return false;
+  }
+
+  mkdir((to + rel).c_str(), S_IRWXU);
+
+  while (auto entry = readdir(dir)) {
+    string name {entry->d_name};
+
+    if (name == "." || name == "..")
+      continue;
+
+    string path {rel + name};
+    struct stat buf;
+
+    if (stat((from + path).c_str(), &buf) != 0)
+      continue;
+
+    if (S_ISDIR(buf.st_mode)) {
+      ok &= mergeDir(from, to, path + "/", merged, move);
+      if (move)
+        rmdir((from + path).c_str());
+      continue;
+    }
+
+    std::ifstream in(from + path);
+    bool append = merged.count(path) > 0;
+
+    std::ofstream out(to + path, append ? std::ios_base::app : std::ios_base::trunc);
+
+    if (append) {
+      string header;
+      std::getline(in, header);
+    }
+
+    if (in.peek() != std::ifstream::traits_type::eof())
+      out << in.rdbuf();
+
+    if (!out) {
+      printf("Error: could not merge '%s' into '%s'\n",
+             (from + path).c_str(), (to + path).c_str());
+      ok = false;
+    }
+
+    merged.insert(path);
+    if (move)
+      unlink((from + path).c_str());
+  }
+
+  closedir(dir);
+
+  return ok;
+}
+
+} // namespace
+
+bool MergeOutputs(const string& from, const string& to, std::set<string>& merged,
+                  bool move)
+{
+  return mergeDir(from, to, "", merged, move);
+}
@@ -0,0 +1,153 @@
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+
+#include <JSONParameterize.h>
+
+#include "../include/TBABM/Model.h"
+
+using namespace SimulationLib::JSONImport;
+
+Model::Model(const json& sheet,
+             const Constants& constants,
+             std::shared_ptr<const HouseholdTemplates> families,
+             bool legacy_rng,
+             FrameCache *frames) : constants(constants)
+{
+  // Initialize the map of simulation parameters
+  std::map<string, Param> params{};
+  mapShortNames( sheet, params );
+
+  // Resolve every parameter the model uses to its ParamID, once. Throws if
+  // a required parameter is missing from the sheet.
+  ParamTable paramTable(params);
+
+  // Point-mass parameters are returned as-is from then on, without sampling
+  paramTable.FoldConstants(sheet, legacy_rng);
+
+  std::shared_ptr<const FrameTable> loaded {};
+  auto& table = frames ? (*frames)[paramTable.Files()] : loaded;
+
+  if (!table)
+    table = std::make_shared<const FrameTable>(paramTable.Files());
+
+  world = std::make_shared<const World>(paramTable, table, families);
+}
+
+Model::Constants
+Model::DefaultConstants(int populationSize, int years)
+{
+  Constants constants {};
+
+  constants["tMax"]           = 365*years;
+  constants["periodLength"]   = 365;
+  constants["ageGroupWidth"]  = 3;
+  constants["startYear"]      = 1990;
+  constants["populationSize"] = populationSize;
+  constants["initThreads"]    = 1;
+  constants["initChunk"]      = 4096;
+
+  return constants;
+}
+
+std::unique_ptr<TrajectoryResult>
+Model::Run(std::uint_fast64_t seed, SurveySink surveys, std::size_t block) const
+{
+  auto traj = TBABM(*world, constants, seed);
+
+  if (surveys)
+    traj.StreamSurveys(surveys, block);
+
+  if (!traj.Run())
+    return nullptr;
+
+  // The population is freed on return; only the results outlive it
+  return std::unique_ptr<TrajectoryResult>(new TrajectoryResult(traj.TakeResults()));
+}
+
+namespace {
+
+// What the tasks of one Run(seeds, executor) share with it. Each task
+// holds it as well, since an executor may keep a task, run or not, after
+// Run has returned.
+struct Pending {
+  explicit Pending(std::size_t n) : remaining(n), trajectories(n) {};
+
+  std::mutex mutex;
+  std::condition_variable done;
+  std::size_t remaining;
+  std::vector<std::unique_ptr<TrajectoryResult>> trajectories;
+};
+
+// Settles trajectory 'i' once: when its task has run, or else when the
+// last copy of the task is destroyed, i.e. the executor dropped it, in
+// which case its result is nullptr.
+class Settle {
+  public:
+    Settle(std::shared_ptr<Pending> pending, std::size_t i) : pending(pending), i(i) {};
+    ~Settle() { Set(nullptr); }
+
+    void Set(std::unique_ptr<TrajectoryResult> result) {
+      // Notified under the lock, so that the waiter can't return before
+      // this is through with it
+      std::lock_guard<std::mutex> lock(pending->mutex);
+
+      if (settled)
+        return;
+
+      settled = true;
+      pending->trajectories[i] = std::move(result);
+
+      if (--pending->remaining == 0)
+        pending->done.notify_all();
+    }
+
+  private:
+    std::shared_ptr<Pending> pending;
+    std::size_t i;
+    bool settled {false};
+};
+
+} // namespace
+
+std::unique_ptr<TrajectoryResult>
+Model::tryRun(std::uint_fast64_t seed) const
+{
+  try {
+    return Run(seed);
+  }
+  catch (const std::exception& e) {
+    fprintf(stderr, "Trajectory of seed %ld threw: %s\n", static_cast<long>(seed), e.what());
+    return nullptr;
+  }
+}
+
+Results
+Model::Run(const std::vector<std::uint_fast64_t>& seeds, const Executor& executor) const
+{
+  Results results(seeds.size());
+
+  if (!executor) {
+    for (std::size_t i = 0; i < seeds.size(); i++)
+      results.trajectories[i] = tryRun(seeds[i]);
+
+    return results;
+  }
+
+  auto pending = std::make_shared<Pending>(seeds.size());
+
+  for (std::size_t i = 0; i < seeds.size(); i++) {
+    auto settle = std::make_shared<Settle>(pending, i);
+    auto seed   = seeds[i];
+
+    executor([this, settle, seed] { settle->Set(tryRun(seed)); });
+  }
+
+  std::unique_lock<std::mutex> lock(pending->mutex);
+  pending->done.wait(lock, [&pending] { return pending->remaining == 0; });
+
+  results.trajectories = std::move(pending->trajectories);
+
+  return results;
+}
@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "../include/TBABM/ParamTable.h"
+
+namespace {
+
+const char *names[] = {
+#define TBABM_PARAM(name, required) #name,
+#include "../include/TBABM/ParamNames.inc"
+#undef TBABM_PARAM
+};
+
+const bool required[] = {
+#define TBABM_PARAM(name, required) required,
+#include "../include/TBABM/ParamNames.inc"
+#undef TBABM_PARAM
+};
+
+} // namespace
+
+ParamTable::ParamTable(const Params& params)
+{
+  std::vector<string> missing {};
+
+  for (std::size_t i = 0; i < table.size(); i++) {
+    auto it = params.find(names[i]);
+
+    if (it != params.end())
+      table[i] = it->second;
+    else if (required[i])
+      missing.emplace_back(names[i]);
+  }
+
+  for (auto it = params.begin(); it != params.end(); it++)
+    if (it->second.getType() == SimulationLib::Type::file_type)
+      files.emplace_back(it->first, it->second.getFileName());
+
+  if (missing.size() > 0) {
+    string error {"the parameter file is missing " + std::to_string(missing.size()) + \
+                  " required parameter(s):"};
+
+    for (auto&& name : missing)
+      error += " " + name;
+
+    throw std::runtime_error(error);
+  }
+}
+
+int
+ParamTable::FoldConstants(const json& sheet, bool legacy_rng)
+{
+  if (!sheet.is_array())
+    return 0;
+
+  int n_folded {0};
+
+  for (auto&& row : sheet) {
+    if (!row.is_object() || \
+        !row.count("short-name") || \
+        !row.count("distribution") || \
+        !row.count("parameter-1"))
+      continue;
+
+    auto& name  = row["short-name"];
+    auto& dist  = row["distribution"];
+    auto& value = row["parameter-1"];
+
+    if (!name.is_string() || !dist.is_string() || !value.is_number())
+      continue;
+
+    auto it = std::find(std::begin(names), std::end(names),
+                        name.get<string>());
+    if (it == std::end(names))
+      continue;
+
+    auto i = static_cast<std::size_t>(it - std::begin(names));
+    auto p = value.get<double>();
+
+    bool point_mass {false};
+
+    if (dist.get<string>() == "Constant")
+      point_mass = true;
+    else if (dist.get<string>() == "Bernoulli" && (p == 0 || p == 1))
+      point_mass = !legacy_rng;
+
+    if (!point_mass)
+      continue;
+
+    folded[i]    = true;
+    constants[i] = static_cast<Value>(p);
+    n_folded    += 1;
+  }
+
+  return n_folded;
+}
+
+const char *
+ParamTable::Name(ParamID id)
+{
+  return names[static_cast<std::size_t>(id)];
+}
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/TBABM/RunOutputs.h"
+#include "../include/TBABM/Columnar.h"
+
+const std::map<string, string>&
+RunOutputs::SurveyHeaders(void)
+{
+  static const std::map<string, string> surveyHeaders {
+    {"population", "trajectory,time,hash,age,sex,marital,household,householdHash,offspring,mom,dad,HIV,ART,CD4,TBStatus"},
+      {"household", "trajectory,time,hash,size,head,spouse,directOffspring,otherOffspring,other"},
+      {"death", "trajectory,time,hash,age,sex,cause,HIV,HIV_date,ART,ART_date,CD4,baseline_CD4"}
+  };
+
+  return surveyHeaders;
+}
+
+RunOutputs::RunOutputs(const string& prefix) : prefix(prefix)
+{
+  auto& surveyHeaders = SurveyHeaders();
+
+  auto prepareSurvey = [this, prefix](std::pair<string, string> name_and_header)
+    -> std::pair<string, std::shared_ptr<ofstream>> {
+
+      // Attempt to initialize files to output surveys to
+      string fname {prefix + name_and_header.first + ".csv"};
+
+      auto temp = std::make_shared<ofstream>(fname, ios_base::out);
+
+      // Handle initialization failures
+      if (temp->fail()) {
+        printf("Attempt to open file '%s' failed\n", fname.c_str());
+        ok = false;
+        return std::make_pair(name_and_header.first, temp);
+      }
+
+      *temp << name_and_header.second << std::endl;
+
+      if (temp->fail()) {
+        printf("Attempt to write header to file '%s' failed\n", fname.c_str());
+        ok = false;
+      }
+
+      return std::make_pair(name_and_header.first, temp);
+    };
+
+  std::transform(surveyHeaders.begin(),
+      surveyHeaders.end(),
+      std::inserter(surveyFiles, surveyFiles.begin()),
+      prepareSurvey);
+
+  string histName {prefix + "ctInfectiousnessAverted.csv"};
+  auto hist = std::make_shared<ofstream>(histName, ios_base::out);
+
+  if (hist->fail()) {
+    printf("Attempt to open file '%s' failed\n", histName.c_str());
+    ok = false;
+  } else {
+    *hist << "seed,lower,upper,value" << std::endl;
+
+    if (hist->fail()) {
+      printf("Attempt to write header to file '%s' failed\n", histName.c_str());
+      ok = false;
+    }
+  }
+
+  histFiles["ctInfectiousnessAverted"] = hist;
+}
+
+bool RunOutputs::Add(std::shared_ptr<TrajectoryResult> t)
+{
+  if (!ok)
+    return false;
+
+  bool success {true};
+  long id {static_cast<long>(t->seed)};
+
+  auto& data = t->data;
+  auto& ctInfectiousnessAverted = histFiles.at("ctInfectiousnessAverted");
+
+  for (auto&& x : indexed(data.ctInfectiousnessAverted, coverage::all)) {
+    *ctInfectiousnessAverted << boost::format("%i,%.1f,%.1f,%i\n")
+      % id % x.bin().lower() % x.bin().upper() % *x;
+  }
+
+  std::cout << std::flush;
+
+  // Each series is handed over as a pointer into 't', which it keeps alive
+#define TBABM_SERIES(name, member) \
+  success &= name.Add(std::shared_ptr<decltype(data.member)>(t, &data.member), id);
+#define TBABM_PYRAMID(name, member) TBABM_SERIES(name, member)
+#include "../include/TBABM/OutputNames.inc"
+#undef TBABM_PYRAMID
+#undef TBABM_SERIES
+
+  success &= t->WriteSurveys(surveyFiles.at("population"),
+                             surveyFiles.at("household"),
+                             surveyFiles.at("death"));
+
+  // The surveys are written, so only the series need be kept
+  string().swap(t->populationSurvey);
+  string().swap(t->householdSurvey);
+  string().swap(t->deathSurvey);
+
+  if (success)
+    added++;
+
+  return success;
+}
+
+bool RunOutputs::AddSurveyRows(SurveyKind survey, const string& rows)
+{
+  if (!ok)
+    return false;
+
+  auto& file = surveyFiles.at(survey == SurveyKind::Population ? "population" :
+                              survey == SurveyKind::Household  ? "household"  : "death");
+
+  *file << rows;
+
+  if (file->fail()) {
+    printf("Write of streamed survey rows failed\n");
+    return false;
+  }
+
+  return true;
+}
+
+bool RunOutputs::Write(void)
+{
+  bool success {ok};
+
+#define TBABM_SERIES(name, member) \
+  success = success && name.Write(prefix + #name ".csv");
+#define TBABM_PYRAMID(name, member) TBABM_SERIES(name, member)
+#include "../include/TBABM/OutputNames.inc"
+#undef TBABM_PYRAMID
+#undef TBABM_SERIES
+
+  for (auto && file : surveyFiles) {
+    file.second->flush();
+    file.second->close();
+  }
+
+  for (auto&& file : histFiles) {
+    file.second->flush();
+    file.second->close();
+  }
+
+  return success;
+}
+
+bool RunOutputs::ToColumnar(const string& prefix)
+{
+  std::vector<string> names {"population", "household", "death", "ctInfectiousnessAverted"};
+
+#define TBABM_SERIES(name, member) names.push_back(#name);
+#define TBABM_PYRAMID(name, member) TBABM_SERIES(name, member)
+#include "../include/TBABM/OutputNames.inc"
+#undef TBABM_PYRAMID
+#undef TBABM_SERIES
+
+  bool success {true};
+
+  for (auto&& name : names) {
+    string csv {prefix + name + ".csv"};
+    struct stat buf;
+
+    // Jobs that all went into another output set leave none here
+    if (stat(csv.c_str(), &buf) != 0)
+      continue;
+
+    string tbc {prefix + name + ".tbc"};
+
+    // The CSV goes only once every value of it has been read back
+    if (Columnar::FromCSV(csv, tbc) && Columnar::Verify(csv, tbc))
+      unlink(csv.c_str());
+    else {
+      printf("Error: '%s' did not convert exactly; it has been kept\n", csv.c_str());
+      unlink(tbc.c_str());
+      success = false;
+    }
+  }
+
+  return success;
+}
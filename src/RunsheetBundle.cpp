@@ -0,0 +1,244 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/TBABM/RunsheetBundle.h"
+
+const char RunsheetBundle::Magic[8] = {'T','B','A','B','M','R','B','1'};
+
+namespace {
+
+// The row of 'runsheet' whose 'short-name' is 'name', or nullptr
+json *FindRow(json& runsheet, const char *name)
+{
+  for (auto&& row : runsheet)
+    if (row.is_object() && row.count("short-name") && row["short-name"] == name)
+      return &row;
+
+  return nullptr;
+}
+
+} // namespace
+
+RunsheetBundle::RunsheetBundle(const char *file)
+{
+  int fd = open(file, O_RDONLY);
+  struct stat buf;
+
+  // The destructor won't run if this throws, so the mapping goes here
+  auto fail = [this] (const string& error) {
+    if (mapping && mapping != MAP_FAILED)
+      munmap(mapping, mapping_size);
+
+    throw std::runtime_error(error);
+  };
+
+  if (fd < 0 || fstat(fd, &buf) != 0) {
+    if (fd >= 0)
+      close(fd);
+    fail("could not open runsheet bundle '" + string(file) + "'");
+  }
+
+  mapping_size = static_cast<std::size_t>(buf.st_size);
+
+  if (mapping_size < sizeof(Header)) {
+    close(fd);
+    fail("'" + string(file) + "' is not a runsheet bundle");
+  }
+
+  mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (mapping == MAP_FAILED)
+    fail("could not map runsheet bundle '" + string(file) + "'");
+
+  auto base = static_cast<const char *>(mapping);
+  header = reinterpret_cast<const Header *>(base);
+
+  if (memcmp(header->magic, Magic, sizeof(Magic)) != 0)
+    fail("'" + string(file) + "' is not a runsheet bundle");
+
+  std::size_t expected = sizeof(Header) + \
+                         header->prototype_size + \
+                         sizeof(Column) * header->n_columns + \
+                         sizeof(double) * header->n_columns * header->n_runs;
+
+  if (mapping_size != expected || header->prototype_size % sizeof(double))
+    fail("runsheet bundle '" + string(file) + "' is malformed");
+
+  prototype = base + sizeof(Header);
+  columns   = reinterpret_cast<const Column *>(prototype + header->prototype_size);
+  values    = reinterpret_cast<const double *>(columns + header->n_columns);
+
+  // Check once that each column names a row of the prototype, so that
+  // Runsheet() can't fail on a well-formed bundle
+  json sheet {};
+
+  try {
+    sheet = json::parse(prototype, prototype + header->prototype_size);
+  }
+  catch (const std::exception&) {
+    fail("runsheet bundle '" + string(file) + "' has a malformed prototype");
+  }
+
+  for (std::uint32_t c = 0; c < header->n_columns; c++) {
+    string name(columns[c].name, strnlen(columns[c].name, NameLength));
+
+    if (!FindRow(sheet, name.c_str()))
+      fail("runsheet bundle '" + string(file) + "' sweeps '" + name + \
+           "', which is not in its prototype");
+  }
+}
+
+RunsheetBundle::~RunsheetBundle(void)
+{
+  if (mapping)
+    munmap(mapping, mapping_size);
+}
+
+json
+RunsheetBundle::Runsheet(std::uint32_t k) const
+{
+  if (k >= header->n_runs)
+    throw std::runtime_error("run " + std::to_string(k) + " requested from a bundle of " + \
+                             std::to_string(header->n_runs) + " runs");
+
+  auto sheet = json::parse(prototype, prototype + header->prototype_size);
+
+  for (std::uint32_t c = 0; c < header->n_columns; c++) {
+    string name(columns[c].name, strnlen(columns[c].name, NameLength));
+
+    Substitute(sheet, name, values[static_cast<std::size_t>(c) * header->n_runs + k]);
+  }
+
+  return sheet;
+}
+
+bool
+RunsheetBundle::Write(const char *file,
+                      const json& prototype,
+                      const std::vector<string>& names,
+                      const std::vector<double>& values)
+{
+  auto proto = prototype;
+
+  if (!proto.is_array()) {
+    printf("Error: the prototype runsheet is not an array of rows\n");
+    return false;
+  }
+
+  if (names.empty() || values.size() % names.size()) {
+    printf("Error: expected one value per swept parameter in each run\n");
+    return false;
+  }
+
+  std::vector<Column> cols(names.size());
+
+  for (std::size_t c = 0; c < names.size(); c++) {
+    if (names[c].size() >= NameLength) {
+      printf("Error: parameter name '%s' is too long\n", names[c].c_str());
+      return false;
+    }
+
+    if (!FindRow(proto, names[c].c_str())) {
+      printf("Error: '%s' is not in the prototype runsheet\n", names[c].c_str());
+      return false;
+    }
+
+    memset(cols[c].name, 0, NameLength);
+    memcpy(cols[c].name, names[c].data(), names[c].size());
+  }
+
+  // Pad the JSON text with whitespace so the values after it are aligned
+  string text = proto.dump();
+  text.append((sizeof(double) - text.size() % sizeof(double)) % sizeof(double), ' ');
+
+  auto n_columns = names.size();
+  auto n_runs    = values.size() / n_columns;
+
+  // Rows of 'values' are runs; the file holds columns
+  std::vector<double> transposed(values.size());
+  for (std::size_t r = 0; r < n_runs; r++)
+    for (std::size_t c = 0; c < n_columns; c++)
+      transposed[c * n_runs + r] = values[r * n_columns + c];
+
+  Header h;
+  memcpy(h.magic, Magic, sizeof(Magic));
+  h.n_runs         = static_cast<std::uint32_t>(n_runs);
+  h.n_columns      = static_cast<std::uint32_t>(n_columns);
+  h.prototype_size = text.size();
+
+  FILE *ofile = fopen(file, "wb");
+  if (!ofile) {
+    printf("Error: could not open '%s' for writing\n", file);
+    return false;
+  }
+
+  bool ok = fwrite(&h, sizeof(h), 1, ofile) == 1 && \
+            fwrite(text.data(), 1, text.size(), ofile) == text.size() && \
+            fwrite(cols.data(), sizeof(Column), n_columns, ofile) == n_columns && \
+            fwrite(transposed.data(), sizeof(double), transposed.size(), ofile) == transposed.size();
+
+  if (fclose(ofile) != 0 || !ok) {
+    printf("Error: could not write '%s'\n", file);
+    return false;
+  }
+
+  return true;
+}
+
+bool
+RunsheetBundle::Substitute(json& sheet, const string& name, double value)
+{
+  auto row = FindRow(sheet, name.c_str());
+
+  if (!row)
+    return false;
+
+  (*row)["parameter-1"] = value;
+
+  return true;
+}
+
+bool
+RunsheetBundle::IsBundle(const char *file)
+{
+  char magic[sizeof(Magic)];
+  FILE *ifile = fopen(file, "rb");
+
+  if (!ifile)
+    return false;
+
+  bool is_bundle = fread(magic, 1, sizeof(magic), ifile) == sizeof(magic) && \
+                   memcmp(magic, Magic, sizeof(Magic)) == 0;
+
+  fclose(ifile);
+
+  return is_bundle;
+}
+
+bool
+RunsheetBundle::ParseSelector(const string& arg, string& file, std::uint32_t& k)
+{
+  auto hash = arg.rfind('#');
+
+  if (hash == string::npos || hash == 0 || hash + 1 == arg.size())
+    return false;
+
+  char *end {nullptr};
+  auto run = strtoul(arg.c_str() + hash + 1, &end, 10);
+
+  if (*end != '\0')
+    return false;
+
+  file = arg.substr(0, hash);
+  k    = static_cast<std::uint32_t>(run);
+
+  return true;
+}
@@ -0,0 +1,366 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <set>
+
+#include <sqlite3.h>
+
+#include "../include/TBABM/SQLiteOutputs.h"
+#include "../include/TBABM/RunOutputs.h"
+#include "../include/TBABM/utils/csv.h"
+
+namespace {
+
+// Rows inserted per transaction
+const int batch {100000};
+
+// Binds 'field' as the number it is, or else as text. An empty field is
+// NULL.
+void bindField(sqlite3_stmt *stmt, int k, const string& field)
+{
+  const char *s = field.c_str();
+  char *end {nullptr};
+
+  if (field.empty()) {
+    sqlite3_bind_null(stmt, k);
+    return;
+  }
+
+  errno = 0;
+  long long i = strtoll(s, &end, 10);
+
+  if (*end == '\0' && errno != ERANGE) {
+    sqlite3_bind_int64(stmt, k, i);
+    return;
+  }
+
+  double d = strtod(s, &end);
+
+  if (*end == '\0')
+    sqlite3_bind_double(stmt, k, d);
+  else
+    sqlite3_bind_text(stmt, k, s, field.size(), SQLITE_TRANSIENT);
+}
+
+void bindJSON(sqlite3_stmt *stmt, int k, const json& value)
+{
+  if (value.is_number())
+    sqlite3_bind_double(stmt, k, value.get<double>());
+  else if (value.is_string() && value.get<string>() != "")
+    sqlite3_bind_text(stmt, k, value.get<string>().c_str(), -1, SQLITE_TRANSIENT);
+  else
+    sqlite3_bind_null(stmt, k);
+}
+
+// "a","b",... for a column list
+string quoted(const std::vector<string>& names)
+{
+  string list {};
+
+  for (auto&& name : names)
+    list += (list.empty() ? "\"" : ",\"") + name + "\"";
+
+  return list;
+}
+
+string parameters(std::size_t n)
+{
+  string list {"?"};
+
+  for (std::size_t k = 1; k < n; k++)
+    list += ",?";
+
+  return list;
+}
+
+} // namespace
+
+SQLiteOutputs::SQLiteOutputs(const string& path)
+{
+  if (sqlite3_open(path.c_str(), &db) != SQLITE_OK) {
+    printf("Error: could not open database '%s': %s\n", path.c_str(), sqlite3_errmsg(db));
+    exit(EXIT_FAILURE);
+  }
+
+  bool ok = exec("PRAGMA journal_mode=WAL") && exec("PRAGMA synchronous=NORMAL");
+
+  ok = ok && exec("CREATE TABLE IF NOT EXISTS runs "
+                  "(run INTEGER PRIMARY KEY, job TEXT, spec TEXT, seed INTEGER, started INTEGER)");
+  ok = ok && exec("CREATE TABLE IF NOT EXISTS parameters "
+                  "(run INTEGER, name TEXT, distribution TEXT, p1, p2, p3, p4)");
+  ok = ok && exec("CREATE TABLE IF NOT EXISTS trajectories "
+                  "(run INTEGER, trajectory INTEGER, ok INTEGER)");
+  ok = ok && exec("CREATE TABLE IF NOT EXISTS series "
+                  "(run INTEGER, name TEXT, trajectory INTEGER, period INTEGER, value REAL)");
+  ok = ok && exec("CREATE TABLE IF NOT EXISTS pyramids "
+                  "(run INTEGER, name TEXT, trajectory INTEGER, period INTEGER, "
+                  "category TEXT, age_group TEXT, value REAL)");
+  ok = ok && exec("CREATE TABLE IF NOT EXISTS ctInfectiousnessAverted "
+                  "(run INTEGER, trajectory INTEGER, lower REAL, upper REAL, value INTEGER)");
+
+  ok = ok && exec("CREATE INDEX IF NOT EXISTS parameters_run ON parameters (run)");
+  ok = ok && exec("CREATE INDEX IF NOT EXISTS trajectories_run ON trajectories (run, trajectory)");
+  ok = ok && exec("CREATE INDEX IF NOT EXISTS series_run ON series (run, trajectory, period)");
+  ok = ok && exec("CREATE INDEX IF NOT EXISTS pyramids_run ON pyramids (run, trajectory, period)");
+
+  insertRun        = prepare("INSERT INTO runs (job, spec, seed, started) VALUES (?,?,?,?)");
+  insertParameter  = prepare("INSERT INTO parameters VALUES (?,?,?,?,?,?,?)");
+  insertTrajectory = prepare("INSERT INTO trajectories VALUES (?,?,?)");
+  insertSeries     = prepare("INSERT INTO series VALUES (?,?,?,?,?)");
+  insertPyramid    = prepare("INSERT INTO pyramids VALUES (?,?,?,?,?,?,?)");
+  insertHist       = prepare("INSERT INTO ctInfectiousnessAverted VALUES (?,?,?,?,?)");
+
+  // A survey's table has the columns of its CSV, after 'run'
+  for (auto&& survey : RunOutputs::SurveyHeaders()) {
+    auto& name = survey.first;
+    auto columns = SplitCSV(survey.second);
+
+    ok = ok && exec("CREATE TABLE IF NOT EXISTS " + name + " (run INTEGER," + quoted(columns) + ")");
+    ok = ok && exec("CREATE INDEX IF NOT EXISTS " + name + "_run ON " + name + " (run, trajectory, time)");
+
+    insertSurvey[name] = prepare("INSERT INTO " + name + " VALUES (" + parameters(columns.size() + 1) + ")");
+  }
+
+  if (!ok || !insertRun || !insertParameter || !insertTrajectory ||
+      !insertSeries || !insertPyramid || !insertHist) {
+    printf("Error: could not set up database '%s'\n", path.c_str());
+    exit(EXIT_FAILURE);
+  }
+}
+
+SQLiteOutputs::~SQLiteOutputs(void)
+{
+  for (auto stmt : {insertRun, insertParameter, insertTrajectory,
+                    insertSeries, insertPyramid, insertHist})
+    sqlite3_finalize(stmt);
+
+  for (auto&& stmt : insertSurvey)
+    sqlite3_finalize(stmt.second);
+
+  sqlite3_close(db);
+}
+
+bool
+SQLiteOutputs::exec(const string& sql)
+{
+  char *error {nullptr};
+
+  if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &error) != SQLITE_OK) {
+    printf("Error: database: %s\n", error ? error : sqlite3_errmsg(db));
+    sqlite3_free(error);
+    return false;
+  }
+
+  return true;
+}
+
+sqlite3_stmt *
+SQLiteOutputs::prepare(const string& sql)
+{
+  sqlite3_stmt *stmt {nullptr};
+
+  if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    printf("Error: database: %s\n", sqlite3_errmsg(db));
+    return nullptr;
+  }
+
+  return stmt;
+}
+
+std::int64_t
+SQLiteOutputs::AddRun(const string& job, const string& spec,
+                      std::uint_fast64_t seed, const json& sheet)
+{
+  exec("BEGIN");
+
+  sqlite3_bind_text(insertRun, 1, job.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(insertRun, 2, spec.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int64(insertRun, 3, static_cast<sqlite3_int64>(seed));
+  sqlite3_bind_int64(insertRun, 4, static_cast<sqlite3_int64>(std::time(NULL)));
+
+  bool ok = sqlite3_step(insertRun) == SQLITE_DONE;
+  sqlite3_reset(insertRun);
+
+  std::int64_t run = sqlite3_last_insert_rowid(db);
+
+  // A runsheet is an array of rows, one per parameter
+  if (sheet.is_array())
+    for (auto&& row : sheet) {
+      if (!row.is_object() || !row.count("short-name"))
+        continue;
+
+      sqlite3_bind_int64(insertParameter, 1, run);
+      bindJSON(insertParameter, 2, row["short-name"]);
+      bindJSON(insertParameter, 3, row.count("distribution") ? row["distribution"] : json());
+
+      for (int k = 1; k <= 4; k++) {
+        string p {"parameter-" + std::to_string(k)};
+        bindJSON(insertParameter, 3 + k, row.count(p) ? row[p] : json());
+      }
+
+      ok = ok && sqlite3_step(insertParameter) == SQLITE_DONE;
+      sqlite3_reset(insertParameter);
+    }
+
+  ok = exec("COMMIT") && ok;
+
+  if (!ok)
+    printf("Error: could not record job %s in the database: %s\n", job.c_str(), sqlite3_errmsg(db));
+
+  return run;
+}
+
+bool
+SQLiteOutputs::AddTrajectory(std::int64_t run, std::uint_fast64_t seed, bool ok)
+{
+  long id {static_cast<long>(seed)};
+
+  auto recorded = runs.emplace(id, run);
+  if (!recorded.second && recorded.first->second != run)
+    recorded.first->second = -1;
+
+  sqlite3_bind_int64(insertTrajectory, 1, run);
+  sqlite3_bind_int64(insertTrajectory, 2, id);
+  sqlite3_bind_int(insertTrajectory, 3, ok);
+
+  bool done = sqlite3_step(insertTrajectory) == SQLITE_DONE;
+  sqlite3_reset(insertTrajectory);
+
+  return done;
+}
+
+bool
+SQLiteOutputs::load(const string& fname, sqlite3_stmt *insert, std::int64_t run,
+                    const std::vector<string>& fixed, const std::vector<string>& columns)
+{
+  std::ifstream in(fname);
+  string line;
+
+  // Jobs that all went into another output set leave nothing here
+  if (!in.is_open())
+    return true;
+
+  if (!std::getline(in, line)) {
+    printf("Error: could not read '%s'\n", fname.c_str());
+    return false;
+  }
+
+  // Where each column is in the file. The first is the trajectory.
+  auto header = SplitCSV(line);
+  std::vector<std::size_t> at {};
+
+  for (auto&& column : columns) {
+    std::size_t k {0};
+    while (k < header.size() && header[k] != column)
+      k++;
+
+    if (k == header.size()) {
+      printf("Error: '%s' has no column '%s'\n", fname.c_str(), column.c_str());
+      return false;
+    }
+
+    at.push_back(k);
+  }
+
+  bool ok = exec("BEGIN");
+  int rows {0};
+  std::set<long> ambiguous {};
+
+  while (ok && std::getline(in, line)) {
+    auto fields = SplitCSV(line);
+
+    if (fields.size() != header.size()) {
+      printf("Error: '%s' has a row of %lu fields, not %lu\n",
+             fname.c_str(), fields.size(), header.size());
+      ok = false;
+      break;
+    }
+
+    // The trajectory is its seed, which may be written unsigned; either
+    // way it is read back as the signed ID AddTrajectory recorded
+    long id {static_cast<long>(strtoull(fields[at[0]].c_str(), nullptr, 10))};
+
+    auto of = run;
+
+    if (of < 0) {
+      auto recorded = runs.find(id);
+      if (recorded != runs.end() && recorded->second < 0)
+        ambiguous.insert(id);
+      else if (recorded != runs.end())
+        of = recorded->second;
+    }
+
+    int k {1};
+
+    if (of >= 0)
+      sqlite3_bind_int64(insert, k++, of);
+    else
+      sqlite3_bind_null(insert, k++);
+
+    for (auto&& value : fixed)
+      sqlite3_bind_text(insert, k++, value.c_str(), -1, SQLITE_TRANSIENT);
+
+    sqlite3_bind_int64(insert, k++, id);
+
+    for (std::size_t c = 1; c < at.size(); c++)
+      bindField(insert, k++, fields[at[c]]);
+
+    ok = sqlite3_step(insert) == SQLITE_DONE;
+    sqlite3_reset(insert);
+
+    if (ok && ++rows % batch == 0)
+      ok = exec("COMMIT") && exec("BEGIN");
+  }
+
+  if (!ok) {
+    printf("Error: could not load '%s' into the database: %s\n", fname.c_str(), sqlite3_errmsg(db));
+    exec("ROLLBACK");
+    return false;
+  }
+
+  for (auto id : ambiguous)
+    printf("Warning: trajectory %ld of '%s' is of more than one run; its rows have no run\n",
+           id, fname.c_str());
+
+  return exec("COMMIT");
+}
+
+bool
+SQLiteOutputs::Load(const string& prefix, std::int64_t run)
+{
+  return run >= 0 && loadSet(prefix, run);
+}
+
+bool
+SQLiteOutputs::Load(const string& prefix)
+{
+  return loadSet(prefix, -1);
+}
+
+bool
+SQLiteOutputs::loadSet(const string& prefix, std::int64_t run)
+{
+  bool success {true};
+
+  const std::vector<string> series  {"trajectory", "period", "value"};
+  const std::vector<string> pyramid {"trajectory", "period", "category", "age group", "value"};
+
+#define TBABM_SERIES(name, member) \
+  success &= load(prefix + #name ".csv", insertSeries, run, {#name}, series);
+#define TBABM_PYRAMID(name, member) \
+  success &= load(prefix + #name ".csv", insertPyramid, run, {#name}, pyramid);
+#include "../include/TBABM/OutputNames.inc"
+#undef TBABM_PYRAMID
+#undef TBABM_SERIES
+
+  for (auto&& survey : RunOutputs::SurveyHeaders())
+    success &= load(prefix + survey.first + ".csv", insertSurvey.at(survey.first), run,
+                    {}, SplitCSV(survey.second));
+
+  success &= load(prefix + "ctInfectiousnessAverted.csv", insertHist, run,
+                  {}, {"seed", "lower", "upper", "value"});
+
+  return success;
+}
@@ -0,0 +1,91 @@
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../include/TBABM/Shards.h"
+#include "../include/TBABM/MergeOutputs.h"
+
+
+Shards::Shards(std::size_t items) : size(items > 0 ? items : 1)
+{
+  void *map = mmap(nullptr, size * sizeof(*claims),
+                   PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+  if (map == MAP_FAILED) {
+    printf("Error: could not map shared memory for %lu trajectories\n", size);
+    exit(EXIT_FAILURE);
+  }
+
+  static_assert(ATOMIC_CHAR_LOCK_FREE == 2,
+                "claim flags must be lock-free to be shared between processes");
+
+  claims = static_cast<std::atomic<unsigned char> *>(map);
+
+  for (std::size_t i = 0; i < size; i++)
+    new (&claims[i]) std::atomic<unsigned char>(0);
+}
+
+Shards::~Shards(void)
+{
+  munmap(claims, size * sizeof(*claims));
+}
+
+int
+Shards::Fork(int n, bool& ok)
+{
+  // Anything buffered now would otherwise be written once by each worker
+  fflush(stdout);
+
+  for (int k = 0; k < n; k++) {
+    pid_t pid = fork();
+
+    if (pid == 0)
+      return k;
+
+    if (pid < 0) {
+      printf("Error: could not fork worker %d\n", k);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  ok = true;
+
+  for (int k = 0; k < n; k++) {
+    int status;
+
+    if (wait(&status) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      ok = false;
+  }
+
+  return -1;
+}
+
+string
+Shards::Dir(int k)
+{
+  return ".shard-" + std::to_string(k) + "/";
+}
+
+bool
+Shards::Merge(const string& prefix, int n)
+{
+  std::set<string> merged {};
+  bool ok {true};
+
+  for (int k = 0; k < n; k++) {
+    struct stat buf;
+
+    if (stat((prefix + Dir(k)).c_str(), &buf) != 0)
+      continue;
+
+    ok &= MergeOutputs(prefix + Dir(k), prefix, merged, true);
+    rmdir((prefix + Dir(k)).c_str());
+  }
+
+  return ok;
+}
@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include <RNG.h>
+
+#include "../include/TBABM/Sweep.h"
+#include "../include/TBABM/RunsheetBundle.h"
+
+using StatisticalDistributions::RNG;
+
+namespace Sweep {
+
+namespace {
+
+// Joe & Kuo (2008), new-joe-kuo-6.21201: for dimensions 2..21, the degree
+// 's' and coefficients 'a' of a primitive polynomial, and its initial
+// direction numbers m_1..m_s. Dimension 1 is the van der Corput sequence.
+struct Direction {
+  int s;
+  unsigned a;
+  unsigned m[7];
+};
+
+const Direction JoeKuo[MaxSobolDimensions - 1] = {
+  {1, 0,  {1}},
+  {2, 1,  {1, 3}},
+  {3, 1,  {1, 3, 1}},
+  {3, 2,  {1, 1, 1}},
+  {4, 1,  {1, 1, 3, 3}},
+  {4, 4,  {1, 3, 5, 13}},
+  {5, 2,  {1, 1, 5, 5, 17}},
+  {5, 4,  {1, 1, 5, 5, 5}},
+  {5, 7,  {1, 1, 7, 11, 19}},
+  {5, 11, {1, 1, 5, 1, 1}},
+  {5, 13, {1, 1, 1, 3, 11}},
+  {5, 14, {1, 3, 5, 5, 31}},
+  {6, 1,  {1, 3, 3, 9, 7, 49}},
+  {6, 13, {1, 1, 1, 15, 21, 21}},
+  {6, 16, {1, 3, 1, 13, 27, 49}},
+  {6, 19, {1, 1, 1, 15, 7, 5}},
+  {6, 22, {1, 3, 1, 15, 13, 25}},
+  {6, 25, {1, 1, 5, 5, 19, 61}},
+  {7, 1,  {1, 3, 7, 11, 23, 15, 103}},
+  {7, 4,  {1, 3, 7, 13, 13, 15, 69}}
+};
+
+const int Bits = 32;
+
+// The 32 direction numbers V_1..V_32 of dimension 'd' (from 0)
+std::vector<std::uint32_t> DirectionNumbers(int d)
+{
+  std::vector<std::uint32_t> v(Bits + 1);
+
+  if (d == 0) {
+    for (int i = 1; i <= Bits; i++)
+      v[i] = 1u << (Bits - i);
+    return v;
+  }
+
+  auto& dir = JoeKuo[d-1];
+
+  for (int i = 1; i <= std::min(dir.s, Bits); i++)
+    v[i] = dir.m[i-1] << (Bits - i);
+
+  for (int i = dir.s + 1; i <= Bits; i++) {
+    v[i] = v[i - dir.s] ^ (v[i - dir.s] >> dir.s);
+
+    for (int k = 1; k < dir.s; k++)
+      v[i] ^= ((dir.a >> (dir.s - 1 - k)) & 1) * v[i-k];
+  }
+
+  return v;
+}
+
+// Number of values seq(lower, upper, step) takes, as R computes it
+std::size_t SeqLength(const Range& r)
+{
+  if (r.step <= 0 || r.upper < r.lower) {
+    if (r.upper == r.lower)
+      return 1;
+
+    printf("Error: range '%s' has no values from %g to %g by %g\n",
+           r.name.c_str(), r.lower, r.upper, r.step);
+    exit(EXIT_FAILURE);
+  }
+
+  return static_cast<std::size_t>(std::floor((r.upper - r.lower) / r.step + 1e-10)) + 1;
+}
+
+// Splits one line of a CSV into fields, honouring double-quoted fields
+std::vector<string> SplitCSV(const string& line)
+{
+  std::vector<string> fields(1);
+  bool quoted {false};
+
+  for (std::size_t i = 0; i < line.size(); i++) {
+    char c = line[i];
+
+    if (quoted && c == '"' && i + 1 < line.size() && line[i+1] == '"') {
+      fields.back() += '"';
+      i++;
+    } else if (c == '"')
+      quoted = !quoted;
+    else if (c == ',' && !quoted)
+      fields.emplace_back();
+    else if (c != '\r')
+      fields.back() += c;
+  }
+
+  return fields;
+}
+
+bool ToNumber(const string& s, double& out)
+{
+  char *end {nullptr};
+  out = std::strtod(s.c_str(), &end);
+
+  return !s.empty() && *end == '\0';
+}
+
+} // namespace
+
+std::vector<Range>
+ReadRanges(const char *file)
+{
+  std::ifstream in(file);
+  string line;
+
+  if (!in || !std::getline(in, line)) {
+    printf("Error: could not read range file '%s'\n", file);
+    exit(EXIT_FAILURE);
+  }
+
+  auto header = SplitCSV(line);
+  int name {-1}, lower {-1}, upper {-1}, step {-1};
+
+  for (int i = 0; i < static_cast<int>(header.size()); i++) {
+    if (header[i] == "name")
+      name = i;
+    else if (header[i] == "lower" || header[i] == "min")
+      lower = i;
+    else if (header[i] == "upper" || header[i] == "max")
+      upper = i;
+    else if (header[i] == "step")
+      step = i;
+  }
+
+  if (name < 0 || lower < 0 || upper < 0) {
+    printf("Error: range file '%s' needs columns name, lower (or min) and upper (or max)\n",
+           file);
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<Range> ranges {};
+  int lines {1};
+
+  while (std::getline(in, line)) {
+    lines++;
+
+    if (line.empty() || line == "\r")
+      continue;
+
+    auto fields = SplitCSV(line);
+    Range r {};
+
+    if (static_cast<int>(fields.size()) <= std::max({name, lower, upper, step}) || \
+        !ToNumber(fields[lower], r.lower) || \
+        !ToNumber(fields[upper], r.upper) || \
+        (step >= 0 && !ToNumber(fields[step], r.step))) {
+      printf("Error: line %d of range file '%s' is malformed\n", lines, file);
+      exit(EXIT_FAILURE);
+    }
+
+    r.name = fields[name];
+    ranges.push_back(r);
+  }
+
+  return ranges;
+}
+
+std::vector<double>
+Generate(Design design,
+         const std::vector<Range>& ranges,
+         std::uint32_t n,
+         std::uint64_t seed)
+{
+  auto d = ranges.size();
+  std::vector<double> values {};
+
+  if (d == 0) {
+    printf("Error: a sweep needs at least one range\n");
+    exit(EXIT_FAILURE);
+  }
+
+  switch (design) {
+    case Design::Grid: {
+      std::vector<std::size_t> lengths(d);
+      std::size_t total {1};
+
+      for (std::size_t j = 0; j < d; j++) {
+        lengths[j] = SeqLength(ranges[j]);
+        total     *= lengths[j];
+      }
+
+      values.resize(total * d);
+
+      // The first range varies fastest, as in purrr::cross
+      for (std::size_t k = 0; k < total; k++) {
+        auto rest = k;
+        for (std::size_t j = 0; j < d; j++) {
+          values[k*d + j] = ranges[j].lower + (rest % lengths[j]) * ranges[j].step;
+          rest /= lengths[j];
+        }
+      }
+
+      break;
+    }
+
+    case Design::LHS: {
+      RNG rng(seed);
+      std::uniform_real_distribution<double> unif(0, 1);
+      std::vector<std::uint32_t> strata(n);
+
+      values.resize(static_cast<std::size_t>(n) * d);
+
+      // Each range is cut into 'n' strata, and each stratum is used by
+      // exactly one point
+      for (std::size_t j = 0; j < d; j++) {
+        std::iota(strata.begin(), strata.end(), 0);
+        std::shuffle(strata.begin(), strata.end(), rng.mt_);
+
+        for (std::uint32_t k = 0; k < n; k++) {
+          double u = (strata[k] + unif(rng.mt_)) / n;
+          values[k*d + j] = ranges[j].lower + u * (ranges[j].upper - ranges[j].lower);
+        }
+      }
+
+      break;
+    }
+
+    case Design::Sobol: {
+      if (d > static_cast<std::size_t>(MaxSobolDimensions)) {
+        printf("Error: Sobol designs support at most %d ranges, not %lu\n",
+               MaxSobolDimensions, d);
+        exit(EXIT_FAILURE);
+      }
+
+      RNG rng(seed);
+      values.resize(static_cast<std::size_t>(n) * d);
+
+      for (std::size_t j = 0; j < d; j++) {
+        auto v = DirectionNumbers(static_cast<int>(j));
+        auto shift = static_cast<std::uint32_t>(rng.mt_());
+
+        // Gray-code order: point k differs from point k-1 by a single
+        // direction number, that of the lowest zero bit of k-1
+        std::uint32_t x {0};
+
+        for (std::uint32_t k = 0; k < n; k++) {
+          if (k > 0) {
+            std::uint32_t c {1};
+            for (auto i = k - 1; i & 1; i >>= 1)
+              c++;
+            x ^= v[c];
+          }
+
+          double u = (x ^ shift) / 4294967296.0;
+          values[k*d + j] = ranges[j].lower + u * (ranges[j].upper - ranges[j].lower);
+        }
+      }
+
+      break;
+    }
+  }
+
+  return values;
+}
+
+json
+ReadRunsheetCSV(const char *file)
+{
+  std::ifstream in(file);
+  string line;
+
+  if (!in || !std::getline(in, line))
+    throw std::runtime_error("could not read runsheet '" + string(file) + "'");
+
+  auto header = SplitCSV(line);
+  json sheet = json::array();
+
+  while (std::getline(in, line)) {
+    if (line.empty() || line == "\r")
+      continue;
+
+    auto fields = SplitCSV(line);
+    json row = json::object();
+
+    for (std::size_t i = 0; i < header.size(); i++) {
+      const string& key = header[i];
+      string field = i < fields.size() ? fields[i] : "";
+      double v;
+
+      // Mirror the types csvjson infers for this format's columns
+      if (field.empty())
+        row[key] = nullptr;
+      else if (key.compare(0, 10, "parameter-") == 0 && ToNumber(field, v))
+        row[key] = v;
+      else if (key == "included-in-calibration" && (field == "T" || field == "F"))
+        row[key] = field == "T";
+      else
+        row[key] = field;
+    }
+
+    sheet.push_back(row);
+  }
+
+  return sheet;
+}
+
+void
+Apply(json& sheet,
+      const std::vector<Range>& ranges,
+      const std::vector<double>& values,
+      std::uint32_t k)
+{
+  auto d = ranges.size();
+
+  if (static_cast<std::size_t>(k) * d + d > values.size())
+    throw std::runtime_error("parameter set " + std::to_string(k) + \
+                             " requested from a sweep of " + \
+                             std::to_string(d ? values.size() / d : 0));
+
+  for (std::size_t j = 0; j < d; j++)
+    if (!RunsheetBundle::Substitute(sheet, ranges[j].name, values[k*d + j]))
+      throw std::runtime_error("swept parameter '" + ranges[j].name + \
+                               "' is not in the runsheet");
+}
+
+} // namespace Sweep
@@ -1,13 +1,14 @@
 #include <iostream>
 
 #include "../../include/TBABM/TB.h"
+#include "../../include/TBABM/Household.h"
 #include "../../include/TBABM/utils/termcolor.h"
 
   void
 TB::Log(Time t, string msg)
 {
   std::cout << termcolor::on_green << "[" << std::left \
-    << std::setw(12) << name << std::setw(5) << std::right \
+    << std::setw(12) << Names::lookup(name) << std::setw(5) << std::right \
     << (int)t << "] " \
     << msg << termcolor::reset << std::endl;
 }
@@ -30,46 +31,15 @@ TB::GetHIVType(Time t)
 }
 
   void
-TB::SetHouseholdCallbacks(
-  function<ContactTraceResult(const Time&, Param&, Param&, RNG&)> contactTrace,
-  function<void(Time)>       progression, 
-  function<void(Time)>       recovery,
-  function<double(void)>     householdPrevalence,
-  function<double(TBStatus)> contactHouseholdPrevalence,
-  function<int(int, int)>    householdTBCases,
-  function<int(int, int)>    householdSize)
+TB::SetHousehold(long hid)
 {
-  if (!(contactTrace &&
-        progression && 
-        recovery && 
-        householdPrevalence && 
-        contactHouseholdPrevalence &&
-        householdTBCases &&
-        householdSize)) {
-
-    printf("A household callback in SetHouseholdCallbacks was empty\n");
-    exit(1);
-  }
-
-  ContactTraceHandler          = contactTrace;
-  ProgressionHandler           = progression;
-  RecoveryHandler              = recovery;
-  HouseholdTBPrevalence        = householdPrevalence;
-  ContactHouseholdTBPrevalence = contactHouseholdPrevalence;
-  HouseholdTBCases             = householdTBCases;
-  HouseholdSize                = householdSize;
+  household_id = hid;
 }
 
   void
-TB::ResetHouseholdCallbacks(void)
+TB::ResetHousehold(void)
 {
-  ContactTraceHandler          = nullptr;
-  ProgressionHandler           = nullptr;
-  RecoveryHandler              = nullptr;
-  HouseholdTBPrevalence        = nullptr;
-  ContactHouseholdTBPrevalence = nullptr;
-  HouseholdTBCases             = nullptr;
-  HouseholdSize                = nullptr;
+  household_id = -1;
 }
 
 // This function is an interface to the death mechanism provided
@@ -79,9 +49,7 @@ TB::ResetHouseholdCallbacks(void)
 void
 TB::InternalDeathHandler(Time t)
 {
-  auto lambda = [this, lifetm = GetLifetimePtr()] (auto ts_, auto) -> bool {
-
-    assert(lifetm);
+  auto lambda = [this] (auto ts_, auto) -> bool {
 
     if (!AliveStatus())
       return true;
@@ -120,7 +88,7 @@ TB::InternalDeathHandler(Time t)
     return true;
   };
 
-  eq.QuickSchedule(t, lambda);
+  Schedule(t, lambda);
 }
 
 // This function is called by Individual AFTER death is assured to happen.
@@ -211,10 +179,7 @@ void TB::EnterAdulthood(void)
   int t_enters_adulthood = init_time + 365*(age_of_adulthood-age_in_years);
 
   auto lambda = [this, 
-       t_enters_adulthood, 
-       lifetm = GetLifetimePtr()] (auto ts_, auto) -> bool {
-
-         assert(lifetm);
+       t_enters_adulthood] (auto ts_, auto) -> bool {
 
          if (!AliveStatus())
            return true;
@@ -237,7 +202,7 @@ void TB::EnterAdulthood(void)
          return true;
        };
 
-  eq.QuickSchedule(t_enters_adulthood, lambda);
+  Schedule(t_enters_adulthood, lambda);
 
   return;
 }
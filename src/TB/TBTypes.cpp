@@ -12,12 +12,11 @@ TBQueryHandlers CreateTBQueryHandlers(function<int(Time)> Age,
     function<double(Time)> CD4Count,
     function<HIVStatus(void)> GetHIVStatus,
     function<bool(void)> ARTStatus,
-    function<double(Time)> GlobalTBPrevalence,
-    function<shared_p<TB>(void)> Lifetime)
+    function<double(Time)> GlobalTBPrevalence)
 {
   if (!Age || !Alive || \
       !CD4Count || !GetHIVStatus || !ARTStatus || \
-      !GlobalTBPrevalence || !Lifetime) {
+      !GlobalTBPrevalence) {
     printf("Error: >= 1 argument to CreateTBHandlers contained empty std::function\n");
     exit(1);
   }
@@ -28,7 +27,6 @@ TBQueryHandlers CreateTBQueryHandlers(function<int(Time)> Age,
     std::move(CD4Count),
     std::move(GetHIVStatus),
     std::move(ARTStatus),
-    std::move(GlobalTBPrevalence),
-    std::move(Lifetime)
+    std::move(GlobalTBPrevalence)
   };
 }
@@ -7,11 +7,9 @@
 void
 TB::InfectInfectious(Time t, Source s, StrainType)
 {
-  auto lambda = [this, s, lifetm = GetLifetimePtr()] (auto ts_, auto) {
+  auto lambda = [this, s] (auto ts_, auto) {
     auto ts = static_cast<int>(ts_);
 
-    assert(lifetm);
-
     if (!AliveStatus())
       return true;
 
@@ -52,52 +50,51 @@ TB::InfectInfectious(Time t, Source s, StrainType)
     // Mark as infectious
     tb_status = TBStatus::Infectious;
 
-    assert(ProgressionHandler);
-    ProgressionHandler(ts);
+    assert(household_id != -1);
+    households.TBProgression(household_id, ts, this);
 
-    Param t_seek_tx;
-    Param t_death;
-    Param t_recov;
+    ParamID t_death;
+    ParamID t_recov;
 
     HIVType hiv_cat = GetHIVType(ts);
 
-    long double seek_tx_base_rate { 1.0/params["TB_seek_tx_base_time"].Sample(rng) };
+    long double seek_tx_base_rate { 1.0/params.Sample(ParamID::TB_seek_tx_base_time, rng) };
     
     if (treatment_experienced) {
       if (hiv_cat == HIVType::Neg) {
-        seek_tx_base_rate  *= params["TB_seek_tx_pt_scalar"].Sample(rng);
-        t_death             = params["TB_t_death"];
-        t_recov             = params["TB_t_recov"];
+        seek_tx_base_rate  *= params.Sample(ParamID::TB_seek_tx_pt_scalar, rng);
+        t_death             = ParamID::TB_t_death;
+        t_recov             = ParamID::TB_t_recov;
       } else if (hiv_cat == HIVType::Good) {
-        seek_tx_base_rate  *= params["TB_seek_tx_pt_goodHIV_scalar"].Sample(rng);
-        t_death             = params["TB_t_death_goodHIV"];
-        t_recov             = params["TB_t_recov_goodHIV"];
+        seek_tx_base_rate  *= params.Sample(ParamID::TB_seek_tx_pt_goodHIV_scalar, rng);
+        t_death             = ParamID::TB_t_death_goodHIV;
+        t_recov             = ParamID::TB_t_recov_goodHIV;
       } else {
-        seek_tx_base_rate  *= params["TB_seek_tx_pt_badHIV_scalar"].Sample(rng);
-        t_death             = params["TB_t_death_badHIV"];
-        t_recov             = params["TB_t_recov_badHIV"];
+        seek_tx_base_rate  *= params.Sample(ParamID::TB_seek_tx_pt_badHIV_scalar, rng);
+        t_death             = ParamID::TB_t_death_badHIV;
+        t_recov             = ParamID::TB_t_recov_badHIV;
       }
     } else {
       if (hiv_cat == HIVType::Neg) {
         seek_tx_base_rate  *= 1;
-        t_death             = params["TB_t_death"];
-        t_recov             = params["TB_t_recov"];
+        t_death             = ParamID::TB_t_death;
+        t_recov             = ParamID::TB_t_recov;
       } else if (hiv_cat == HIVType::Good) {
-        seek_tx_base_rate  *= params["TB_seek_tx_goodHIV_scalar"].Sample(rng);
-        t_death             = params["TB_t_death_goodHIV"];
-        t_recov             = params["TB_t_recov_goodHIV"];
+        seek_tx_base_rate  *= params.Sample(ParamID::TB_seek_tx_goodHIV_scalar, rng);
+        t_death             = ParamID::TB_t_death_goodHIV;
+        t_recov             = ParamID::TB_t_recov_goodHIV;
       } else {
-        seek_tx_base_rate  *= params["TB_seek_tx_badHIV_scalar"].Sample(rng);
-        t_death             = params["TB_t_death_badHIV"];
-        t_recov             = params["TB_t_recov_badHIV"];
+        seek_tx_base_rate  *= params.Sample(ParamID::TB_seek_tx_badHIV_scalar, rng);
+        t_death             = ParamID::TB_t_death_badHIV;
+        t_recov             = ParamID::TB_t_recov_badHIV;
       }
     }
 
     // We have now computed the rate of seeking treatment for this individual.
     auto seek_tx_rate = seek_tx_base_rate;
 
-    auto timeToNaturalRecovery	= t_recov.Sample(rng);
-    auto timeToDeath            = t_death.Sample(rng);
+    auto timeToNaturalRecovery	= params.Sample(t_recov, rng);
+    auto timeToDeath            = params.Sample(t_death, rng);
     auto timeToSeekingTreatment = Exponential(seek_tx_rate)(rng.mt_);
 
     auto winner =
@@ -126,7 +123,7 @@ TB::InfectInfectious(Time t, Source s, StrainType)
     return true;
   };
 
-  eq.QuickSchedule(t, lambda);
+  Schedule(t, lambda);
 
   return;
 }
@@ -17,12 +17,8 @@
 #define SMALLNUM 0.000000000000001
 
 bool
-TB::InfectionRiskEvaluate_impl(Time t, int risk_window_local, shared_p<TB> l_ptr)
+TB::InfectionRiskEvaluate_impl(Time t, int risk_window_local)
 {
-  // Make sure that the "lifetime pointer" for the individual still exisets.
-  // Disabled under -03 compilation.
-  assert(l_ptr);
-
   // Don't run this event if the individual has died in the meantime.
   // Also, don't run it if this event's risk-window-id has become out of
   // phase due to an infection or a risk re-evaluation due to infection in
@@ -57,22 +53,22 @@ TB::InfectionRiskEvaluate_impl(Time t, int risk_window_local, shared_p<TB> l_ptr
   // Calculate any relevant risk reduction
   if (previously_treated) {
     if (hiv_cat == HIVType::Neg)
-      reduction = 1-params["TB_risk_reduction"].Sample(rng);
+      reduction = 1-params.Sample(ParamID::TB_risk_reduction, rng);
     else if (hiv_cat == HIVType::Good)
-      reduction = 1-params["TB_risk_reduction_goodHIV"].Sample(rng);
+      reduction = 1-params.Sample(ParamID::TB_risk_reduction_goodHIV, rng);
     else // badHIV
-      reduction = 1-params["TB_risk_reduction_badHIV"].Sample(rng);
+      reduction = 1-params.Sample(ParamID::TB_risk_reduction_badHIV, rng);
   }
    
   long double under5_extrarisk {AgeStatus(t) < 5 ? \
-                                params["TB_under5_scalar"].Sample(rng) : \
+                                params.Sample(ParamID::TB_under5_scalar, rng) : \
                                 1};
 
   // Calculate size of risk from the community, and size of risk from the 
-  // household. "TB_risk_global" and "TB_risk_household" are constants, despite
-  // the fact that a .Sample method is called on them.
+  // household. "TB_risk_global" and "TB_risk_household_scalar" are constants, which
+  // the ParamTable folds at load, so these calls don't sample anything.
   
-  long double base_global_risk {params["TB_risk_global"].Sample(rng)};
+  long double base_global_risk {params.Sample(ParamID::TB_risk_global, rng)};
 
   long double risk_global     {under5_extrarisk * \
                                reduction * \
@@ -81,9 +77,9 @@ TB::InfectionRiskEvaluate_impl(Time t, int risk_window_local, shared_p<TB> l_ptr
 
   long double risk_household  {under5_extrarisk * \
                                reduction * \
-                               ContactHouseholdTBPrevalence(tb_status) * \
+                               households.ContactActiveTBPrevalence(household_id, tb_status) * \
                                base_global_risk * \
-                               params["TB_risk_household_scalar"].Sample(rng)};
+                               params.Sample(ParamID::TB_risk_household_scalar, rng)};
 
   // Time to infection for global and local. If any of these risks are zero,
   // change to a really small number since you can't sample 0-rate exponentials
@@ -95,9 +91,9 @@ TB::InfectionRiskEvaluate_impl(Time t, int risk_window_local, shared_p<TB> l_ptr
   // disease. "TB_p_init_active" is the probability that someone who gets
   // infected initially (vis-as-vis "TB_p_init_infect") will go straight to
   // active disease.
-  if (t < risk_window && params["TB_p_init_infect"].Sample(rng))
+  if (t < risk_window && params.Sample(ParamID::TB_p_init_infect, rng))
     init_infection = true;
-  if (t < risk_window && params["TB_p_init_active"].Sample(rng) && init_infection)
+  if (t < risk_window && params.Sample(ParamID::TB_p_init_active, rng) && init_infection)
     init_active = true;
 
   // If they do get infected, determine what the infection source is. Note:
@@ -122,17 +118,17 @@ TB::InfectionRiskEvaluate_impl(Time t, int risk_window_local, shared_p<TB> l_ptr
     
     HIVType hiv_cat = GetHIVType(t);
 
-    Param risk;
+    ParamID risk;
 
     if (hiv_cat == HIVType::Neg)
-      risk = params["TB_rapidprog_risk"];
+      risk = ParamID::TB_rapidprog_risk;
     else if (hiv_cat == HIVType::Good)
-      risk = params["TB_rapidprog_risk_goodHIV"];
+      risk = ParamID::TB_rapidprog_risk_goodHIV;
     else
-      risk = params["TB_rapidprog_risk_badHIV"];
+      risk = ParamID::TB_rapidprog_risk_badHIV;
 
     // Schedule rapid progression with unspecified strain
-    if (risk.Sample(rng) || init_active)
+    if (params.Sample(risk, rng) || init_active)
       InfectInfectious(t + 365*master_infection_time, infection_source, StrainType::Unspecified);
     // Schedule latent infection with unspecified strain
     else if (tb_status == TBStatus::Susceptible)
@@ -141,7 +137,7 @@ TB::InfectionRiskEvaluate_impl(Time t, int risk_window_local, shared_p<TB> l_ptr
   } else {
     // If individual is not infected, keep scheduling periodic risk
     // evaluations.
-    InfectionRiskEvaluate(t + risk_window, risk_window_local, std::move(l_ptr));
+    InfectionRiskEvaluate(t + risk_window, risk_window_local);
   }
 
   return true;	
@@ -149,15 +145,13 @@ TB::InfectionRiskEvaluate_impl(Time t, int risk_window_local, shared_p<TB> l_ptr
 
 // Wrapper code
 void
-TB::InfectionRiskEvaluate(Time t, int risk_window_local, shared_p<TB> l_ptr)
+TB::InfectionRiskEvaluate(Time t, int risk_window_local)
 {
-  assert(l_ptr);
-
-  auto lambda = [this, risk_window_local, l_ptr] (auto ts, auto) -> bool {
-    return InfectionRiskEvaluate_impl(ts, risk_window_local, l_ptr);
+  auto lambda = [this, risk_window_local] (auto ts, auto) -> bool {
+    return InfectionRiskEvaluate_impl(ts, risk_window_local);
   };
 
-  eq.QuickSchedule(t, lambda);
+  Schedule(t, lambda);
   return;
 }
 
@@ -165,17 +159,11 @@ TB::InfectionRiskEvaluate(Time t, int risk_window_local, shared_p<TB> l_ptr)
 void
 TB::InfectionRiskEvaluate_initial(int local_risk_window)
 {
-  auto l_ptr = GetLifetimePtr();
-  if (!l_ptr) {
-    printf("Empty l_ptr in IRE_initial\n");
-    return;
-  }
-
   double firstRiskEval = Uniform(0, risk_window)(rng.mt_);
-  auto lambda = [this, local_risk_window, l_ptr] (auto ts, auto) -> bool {
-    return InfectionRiskEvaluate_impl(ts, local_risk_window, std::move(l_ptr));
+  auto lambda = [this, local_risk_window] (auto ts, auto) -> bool {
+    return InfectionRiskEvaluate_impl(ts, local_risk_window);
   };
 
-  eq.QuickSchedule(init_time + firstRiskEval, lambda);
+  Schedule(init_time + firstRiskEval, lambda);
   return;
 }
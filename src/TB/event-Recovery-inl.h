@@ -3,10 +3,8 @@
   void
 TB::Recovery(Time t, RecoveryType r, bool flag_override)
 {
-  auto lambda = [this, r, flag_override, l_ptr = GetLifetimePtr()]
+  auto lambda = [this, r, flag_override]
                 (auto ts, auto) -> bool {
-    assert(l_ptr);
-
     if (!AliveStatus())
       return true;
 
@@ -38,14 +36,14 @@ TB::Recovery(Time t, RecoveryType r, bool flag_override)
     tb_status = TBStatus::Latent;
 
     // If they recovered and it's not because they achieved treatment
-    // completion, call the RecoveryHandler
-    if (RecoveryHandler && r == RecoveryType::Natural)
-      RecoveryHandler(ts);
+    // completion, notify the household
+    if (household_id != -1 && r == RecoveryType::Natural)
+      households.TBRecovery(household_id, ts);
 
     risk_window_id += 1;
     
     // Set up periodic evaluation for reinfection
-    InfectionRiskEvaluate(ts, risk_window_id, std::move(l_ptr));
+    InfectionRiskEvaluate(ts, risk_window_id);
 
     // Set up one-time sample for reactivation
     InfectLatent(ts, 
@@ -55,7 +53,7 @@ TB::Recovery(Time t, RecoveryType r, bool flag_override)
     return true;
   };
 
-  eq.QuickSchedule(t, lambda);
+  Schedule(t, lambda);
 
   return;
 }
@@ -6,9 +6,7 @@
   void
 TB::RiskReeval(Time t)
 {
-  auto lambda = [this, l_ptr = GetLifetimePtr()] (auto ts, auto) -> bool {
-    assert(l_ptr);
-
+  auto lambda = [this] (auto ts, auto) -> bool {
     if (!AliveStatus())
       return true;
 
@@ -32,12 +30,12 @@ TB::RiskReeval(Time t)
 
     risk_window_id += 1;
 
-    InfectionRiskEvaluate(ts, risk_window_id, std::move(l_ptr));
+    InfectionRiskEvaluate(ts, risk_window_id);
 
     return true;
   };
 
-  eq.QuickSchedule(t, lambda);
+  Schedule(t, lambda);
 
   return;
 }
@@ -14,11 +14,9 @@ extern CTraceType trace_kind;
 void
 TB::TreatmentBegin(Time t, const bool flag_override)
 {
-  auto lambda = [this, flag_override, lifetm = GetLifetimePtr()]
+  auto lambda = [this, flag_override]
                 (auto ts_, auto) -> bool {
 
-    assert(lifetm);
-
     auto ts = static_cast<int>(ts_);
 
     if (!AliveStatus())
@@ -54,7 +52,7 @@ TB::TreatmentBegin(Time t, const bool flag_override)
 
     // Log(ts, "TB treatment begin");
 
-    auto prev_household = ContactHouseholdTBPrevalence(tb_status);
+    auto prev_household = households.ContactActiveTBPrevalence(household_id, tb_status);
 
     data.tbInTreatment.Record(ts, +1);
     data.tbTreatmentBegin.Record(ts, +1);
@@ -80,32 +78,32 @@ TB::TreatmentBegin(Time t, const bool flag_override)
     int maxage = 150;
 
     data.activeHouseholdContacts.Record(ts,
-      std::max(0, HouseholdTBCases(maxage, ts) - 1)
+      std::max(0, households.infectiousIndividualsUnderAge(household_id, maxage, ts) - 1)
     );
 
     data.totalHouseholdContacts.Record(ts,
-      std::max(0, HouseholdSize(maxage, ts) - 1)
+      std::max(0, households.individualsUnderAge(household_id, maxage, ts) - 1)
     );
 
     data.activeHouseholdContactsUnder5.Record(ts,
-      std::max(0, HouseholdTBCases(5, ts) - 1)
+      std::max(0, households.infectiousIndividualsUnderAge(household_id, 5, ts) - 1)
     );
 
     data.totalHouseholdContactsUnder5.Record(ts,
-      std::max(0, HouseholdSize(5, ts) - 1)
+      std::max(0, households.individualsUnderAge(household_id, 5, ts) - 1)
     );
 
     tb_treatment_status = TBTreatmentStatus::Incomplete;
 
-    if (RecoveryHandler)
-      RecoveryHandler(ts);
+    if (household_id != -1)
+      households.TBRecovery(household_id, ts);
 
     // Will they complete treatment? Assume 100% yes
-    if (params["TB_p_Tx_cmp"].Sample(rng))
-      TreatmentComplete(ts + 365*params["TB_t_Tx_cmp"].Sample(rng),
+    if (params.Sample(ParamID::TB_p_Tx_cmp, rng))
+      TreatmentComplete(ts + 365*params.Sample(ParamID::TB_t_Tx_cmp, rng),
                         flag_override);
     else
-      TreatmentDropout(ts + 365*params["TB_t_Tx_drop"].Sample(rng));
+      TreatmentDropout(ts + 365*params.Sample(ParamID::TB_t_Tx_drop, rng));
 
     // Schedule the moment where they will be marked as "treatment-experienced."
     // Right now, this is 1 month after treatment start
@@ -133,11 +131,11 @@ TB::TreatmentBegin(Time t, const bool flag_override)
 
     if (tracing_period_has_begun && !flag_override && selected) {
       
-      auto delay = 365*params["TB_CT_t_visit"].Sample(rng);
+      auto delay = 365*params.Sample(ParamID::TB_CT_t_visit, rng);
 
       // Schedule a contact trace
-      eq.QuickSchedule(ts + delay, 
-        [this, lifetm] (auto ts_, auto) -> bool {
+      Schedule(ts + delay, 
+        [this] (auto ts_, auto) -> bool {
 
         // Do NOT trace household if dead!! Memory errors...could develop a
         // workaround to this problem. Issue is that when the dead person is
@@ -148,8 +146,9 @@ TB::TreatmentBegin(Time t, const bool flag_override)
           return true;
 
         auto result = 
-          ContactTraceHandler(ts_, params["TB_CT_frac_screened"], 
-                                   params["TB_CT_frac_visit"], rng);
+          households.ContactTrace(household_id, ts_, this,
+            [this] { return params.Sample(ParamID::TB_CT_frac_screened, rng); },
+            [this] { return params.Sample(ParamID::TB_CT_frac_visit, rng); });
 
         if (!result.did_visit)
           return true;
@@ -176,7 +175,7 @@ TB::TreatmentBegin(Time t, const bool flag_override)
     return true;
   };
 
-  eq.QuickSchedule(t, lambda);
+  Schedule(t, lambda);
 
   return;
 }
@@ -184,11 +183,9 @@ TB::TreatmentBegin(Time t, const bool flag_override)
   void
 TB::TreatmentMarkExperienced(Time t, bool flag_override)
 {
-  auto lambda = [this, flag_override, lifetm = GetLifetimePtr()]
+  auto lambda = [this, flag_override]
                 (auto ts_, auto) -> bool {
 
-    assert(lifetm);
-
     if (!AliveStatus())
       return true;
 
@@ -218,7 +215,7 @@ TB::TreatmentMarkExperienced(Time t, bool flag_override)
     return true;
   };
 
-  eq.QuickSchedule(t, lambda);
+  Schedule(t, lambda);
 
   return;
 }
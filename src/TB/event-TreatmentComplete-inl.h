@@ -3,10 +3,8 @@
   void
 TB::TreatmentComplete(Time t, bool flag_override)
 {
-  auto lambda = [this, flag_override, lifetm = GetLifetimePtr()]
+  auto lambda = [this, flag_override]
                 (auto ts_, auto) -> bool {
-    assert(lifetm);
-
     auto ts = static_cast<int>(ts_);
 
     if (!AliveStatus())
@@ -31,7 +29,7 @@ TB::TreatmentComplete(Time t, bool flag_override)
     return true;
   };
 
-  eq.QuickSchedule(t, lambda);
+  Schedule(t, lambda);
 
   return;
 }
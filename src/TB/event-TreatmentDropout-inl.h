@@ -3,9 +3,7 @@
   void
 TB::TreatmentDropout(Time t)
 {
-  auto lambda = [this, lifetm = GetLifetimePtr()] (auto ts_, auto) -> bool {
-    assert(lifetm);
-
+  auto lambda = [this] (auto ts_, auto) -> bool {
     auto ts = static_cast<int>(ts_);
 
     if (!AliveStatus())
@@ -22,7 +20,7 @@ TB::TreatmentDropout(Time t)
     return true;
   };
 
-  eq.QuickSchedule(t, lambda);
+  Schedule(t, lambda);
 
   return;
 }
@@ -5,10 +5,8 @@
   void
 TB::InfectLatent(Time t, Source source, StrainType strain)
 {
-  auto lambda = [this, source, strain, 
-                 lifetm = GetLifetimePtr()] (auto ts_, auto) {
+  auto lambda = [this, source, strain] (auto ts_, auto) {
 
-    assert(lifetm);
     auto ts = static_cast<int>(ts_);
 
     if (!AliveStatus())
@@ -39,35 +37,35 @@ TB::InfectLatent(Time t, Source source, StrainType strain)
     // history, and their HIV status. Here, we select the correct rate
     // parameter to govern the sampling of the 'time to progression'
     HIVType hiv_cat = GetHIVType(ts);
-    Param risk;
+    ParamID risk;
 
     switch (tb_treatment_status) {
       case TBTreatmentStatus::None:
         if (hiv_cat == HIVType::Neg)
-          risk = params.at("TB_reac_TN");
+          risk = ParamID::TB_reac_TN;
         else if (hiv_cat == HIVType::Good)
-          risk = params.at("TB_reac_TN_goodHIV");
+          risk = ParamID::TB_reac_TN_goodHIV;
         else
-          risk = params.at("TB_reac_TN_badHIV");
+          risk = ParamID::TB_reac_TN_badHIV;
         break;
 
       case TBTreatmentStatus::Incomplete:
       case TBTreatmentStatus::Dropout:
         if (hiv_cat == HIVType::Neg)
-          risk = params.at("TB_reac_TI");
+          risk = ParamID::TB_reac_TI;
         else if (hiv_cat == HIVType::Good)
-          risk = params.at("TB_reac_TI_goodHIV");
+          risk = ParamID::TB_reac_TI_goodHIV;
         else
-          risk = params.at("TB_reac_TI_badHIV");
+          risk = ParamID::TB_reac_TI_badHIV;
         break;
 
       case TBTreatmentStatus::Complete:
         if (hiv_cat == HIVType::Neg)
-          risk = params.at("TB_reac_TC");
+          risk = ParamID::TB_reac_TC;
         else if (hiv_cat == HIVType::Good)
-          risk = params.at("TB_reac_TC_goodHIV");
+          risk = ParamID::TB_reac_TC_goodHIV;
         else
-          risk = params.at("TB_reac_TC_badHIV");
+          risk = ParamID::TB_reac_TC_badHIV;
         break;
 
       default:
@@ -77,14 +75,14 @@ TB::InfectLatent(Time t, Source source, StrainType strain)
 
     // NOTE: right now, you always have the same source and strain
     // as your first TB infection!
-    long double timeToActiveDisease = 365*risk.Sample(rng);
+    long double timeToActiveDisease = 365*params.Sample(risk, rng);
 
     InfectInfectious(ts + timeToActiveDisease, source, strain);
 
     return true;
   };
 
-  eq.QuickSchedule(t, lambda);
+  Schedule(t, lambda);
 
   return;
 }
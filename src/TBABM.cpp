@@ -12,16 +12,28 @@ using SchedulerT = EventQueue<double,bool>::SchedulerT;
 
 using namespace StatisticalDistributions;
 
-  MasterData
-TBABM::GetData(void)
+CTraceType trace_kind = CTraceType::None;
+
+  const MasterData&
+TBABM::GetData(void) const
 {
   return data;
 }
 
+  TrajectoryResult
+TBABM::TakeResults(void)
+{
+  return TrajectoryResult{seed,
+                          std::move(data),
+                          std::move(populationSurvey),
+                          std::move(householdSurvey),
+                          std::move(deathSurvey)};
+}
+
   bool
-TBABM::WriteSurveys(shared_p<ofstream> ps, 
+TrajectoryResult::WriteSurveys(shared_p<ofstream> ps, 
     shared_p<ofstream> hs, 
-    shared_p<ofstream> ds)
+    shared_p<ofstream> ds) const
 {
   bool fail = false;
 
@@ -95,9 +107,42 @@ bool TBABM::Run(void)
 
   data.Close();
 
+  if (surveySink) {
+    SurveyRows(SurveyKind::Population, "", true);
+    SurveyRows(SurveyKind::Household,  "", true);
+    SurveyRows(SurveyKind::Death,      "", true);
+  }
+
   return true;
 }
 
+void TBABM::StreamSurveys(SurveySink sink, std::size_t block)
+{
+  surveySink  = sink;
+  surveyBlock = block;
+}
+
+void TBABM::SurveyRows(SurveyKind survey, const string& rows, bool flush)
+{
+  string& buf = survey == SurveyKind::Population ? populationSurvey : \
+                survey == SurveyKind::Household  ? householdSurvey  : deathSurvey;
+
+  buf += rows;
+
+  if (!surveySink || buf.empty() || (!flush && buf.size() < surveyBlock))
+    return;
+
+  // Moved out, so that its memory goes with it
+  surveySink(survey, std::move(buf));
+  buf = string();
+}
+
+void TBABM::AddToPopulation(shared_p<Individual> idv)
+{
+  idv->id = nIndividuals++;
+  population.push_back(idv);
+}
+
 void TBABM::Schedule(int t, EventQueue<>::EventFunc ef)
 {
   auto f = eq.MakeScheduledEvent(t, ef);
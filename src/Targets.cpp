@@ -0,0 +1,127 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#include "../include/TBABM/Targets.h"
+
+namespace {
+
+bool isSeries(const string& name)
+{
+#define TBABM_SERIES(name_, member) \
+  if (name == #name_)               \
+    return true;
+#define TBABM_PYRAMID(name_, member)
+#include "../include/TBABM/OutputNames.inc"
+#undef TBABM_PYRAMID
+#undef TBABM_SERIES
+
+  return false;
+}
+
+} // namespace
+
+std::vector<Target>
+ParseTargets(const string& arg, int startYear, int years)
+{
+  std::vector<Target> targets {};
+  std::stringstream list(arg);
+  string spec;
+
+  while (std::getline(list, spec, ',')) {
+    Target t {spec, spec, "", startYear, startYear + years - 1};
+
+    auto at = spec.find('@');
+    if (at != string::npos) {
+      t.numerator = spec.substr(0, at);
+
+      char *end {nullptr};
+      t.from = static_cast<int>(strtol(spec.c_str() + at + 1, &end, 10));
+      t.to   = *end == '-' ? static_cast<int>(strtol(end + 1, &end, 10)) : t.from;
+
+      if (*end != '\0' || end == spec.c_str() + at + 1) {
+        printf("Error: malformed target '%s'\n", spec.c_str());
+        exit(EXIT_FAILURE);
+      }
+    }
+
+    auto slash = t.numerator.find('/');
+    if (slash != string::npos) {
+      t.denominator = t.numerator.substr(slash + 1);
+      t.numerator   = t.numerator.substr(0, slash);
+    }
+
+    if (!isSeries(t.numerator) || (t.denominator != "" && !isSeries(t.denominator))) {
+      printf("Error: target '%s' does not name an exported time series\n", spec.c_str());
+      exit(EXIT_FAILURE);
+    }
+
+    if (t.from < startYear || t.to < t.from || t.to >= startYear + years) {
+      printf("Error: target '%s' is outside the years %d-%d of the run\n",
+             spec.c_str(), startYear, startYear + years - 1);
+      exit(EXIT_FAILURE);
+    }
+
+    targets.push_back(t);
+  }
+
+  return targets;
+}
+
+double
+Evaluate(const Target& target, MasterData& data, int startYear, int periodLength)
+{
+  auto num = data.Series(target.numerator);
+  auto den = target.denominator != "" ? data.Series(target.denominator) : nullptr;
+
+  double total {0};
+
+  for (int year = target.from; year <= target.to; year++) {
+    double t = (year - startYear) * periodLength + periodLength / 2;
+    double v = (*num)(t);
+
+    if (den) {
+      double d = (*den)(t);
+      v = d != 0 ? v / d : 0;
+    }
+
+    total += v;
+  }
+
+  return total / (target.to - target.from + 1);
+}
+
+void
+TargetStats::Add(const std::vector<double>& values)
+{
+  n++;
+
+  for (std::size_t k = 0; k < mean.size(); k++) {
+    double delta = values[k] - mean[k];
+    mean[k] += delta / n;
+    m2[k]   += delta * (values[k] - mean[k]);
+  }
+}
+
+double
+TargetStats::SE(std::size_t k) const
+{
+  if (n < 2)
+    return INFINITY;
+
+  return std::sqrt(m2[k] / (n - 1) / n);
+}
+
+bool
+TargetStats::Converged(double tolerance, bool relative) const
+{
+  if (n < 2)
+    return false;
+
+  for (std::size_t k = 0; k < mean.size(); k++)
+    if (SE(k) > (relative ? tolerance * std::fabs(mean[k]) : tolerance))
+      return false;
+
+  return true;
+}
@@ -3,19 +3,41 @@
 #include <iostream>
 #include <string>
 #include <future>
+#include <deque>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <set>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <tuple>
+#include <stdexcept>
 #include <sys/stat.h>
 #include <cstdint>
+#include <chrono>
+#include <fstream>
 #include <boost/format.hpp>
 
 #include <Normal.h>
 #include <RNG.h>
-#include <JSONParameterize.h>
 #include <JSONImport.h>
 #include <docopt.h>
 
 #include "../include/TBABM/TBABM.h"
-#include "../include/TBABM/utils/threadpool.h"
+#include "../include/TBABM/Model.h"
 #include "../include/TBABM/TBTypes.h"
+#include "../include/TBABM/RunsheetBundle.h"
+#include "../include/TBABM/Sweep.h"
+#include "../include/TBABM/RunOutputs.h"
+#include "../include/TBABM/JobSource.h"
+#include "../include/TBABM/Targets.h"
+#include "../include/TBABM/Shards.h"
+#include "../include/TBABM/Checkpoint.h"
+#include "../include/TBABM/JobRunner.h"
+#include "../include/TBABM/MemoryBudget.h"
+#include "../include/TBABM/SQLiteOutputs.h"
 
 using Constants = TBABM::Constants;
 
@@ -26,82 +48,6 @@ using std::vector;
 using std::string;
 using std::future;
 
-TimeSeriesExport<int> births;
-TimeSeriesExport<int> deaths;
-TimeSeriesExport<int> marriages;
-TimeSeriesExport<int> divorces;
-TimeSeriesExport<int> households;
-TimeSeriesExport<int> singleToLooking;
-
-TimeSeriesExport<int> populationSize;
-TimeSeriesExport<int> populationChildren;
-TimeSeriesExport<int> populationAdults;
-
-TimeSeriesExport<int> hivNegative;
-TimeSeriesExport<int> hivPositive;
-TimeSeriesExport<int> hivPositiveART;
-
-TimeSeriesExport<int> hivInfections;
-TimeSeriesExport<int> hivDiagnosed;
-TimeSeriesExport<int> hivDiagnosedVCT;
-TimeSeriesExport<int> hivDiagnosesVCT;
-
-TimeSeriesExport<int> tbInfections;
-TimeSeriesExport<int> tbIncidence;
-TimeSeriesExport<int> tbRecoveries;
-
-TimeSeriesExport<int> tbInfectionsHousehold;
-TimeSeriesExport<int> tbInfectionsCommunity;
-
-TimeSeriesExport<int> tbSusceptible;
-TimeSeriesExport<int> tbLatent;
-TimeSeriesExport<int> tbInfectious;
-
-TimeSeriesExport<int> tbExperienced;
-
-TimeSeriesExport<int> tbTreatmentBegin;
-TimeSeriesExport<int> tbTreatmentBeginHIV;
-TimeSeriesExport<int> tbTreatmentBeginChildren;
-TimeSeriesExport<int> tbTreatmentBeginAdultsNaive;
-TimeSeriesExport<int> tbTreatmentBeginAdultsExperienced;
-TimeSeriesExport<int> tbTreatmentEnd;
-TimeSeriesExport<int> tbTreatmentDropout;
-
-TimeSeriesExport<int> tbTxExperiencedAdults;
-TimeSeriesExport<int> tbTxExperiencedInfectiousAdults;
-TimeSeriesExport<int> tbTxNaiveAdults;
-TimeSeriesExport<int> tbTxNaiveInfectiousAdults;
-
-TimeSeriesExport<int> tbInTreatment;
-TimeSeriesExport<int> tbCompletedTreatment;
-TimeSeriesExport<int> tbDroppedTreatment;
-
-TimeSeriesExport<int> tbDeaths;
-TimeSeriesExport<int> tbDeathsHIV;
-TimeSeriesExport<int> tbDeathsUnderFive;
-
-TimeSeriesExport<int> ctHomeVisits;
-TimeSeriesExport<int> ctScreenings;
-TimeSeriesExport<int> ctScreeningsHIV;
-TimeSeriesExport<int> ctScreeningsChildren;
-TimeSeriesExport<int> ctCasesFound;
-TimeSeriesExport<int> ctCasesFoundHIV;
-TimeSeriesExport<int> ctCasesFoundChildren;
-TimeSeriesExport<int> ctDeathsAverted;
-TimeSeriesExport<int> ctDeathsAvertedHIV;
-TimeSeriesExport<int> ctDeathsAvertedChildren;
-
-TimeSeriesExport<int> activeHouseholdContacts;
-TimeSeriesExport<int> activeHouseholdContactsUnder5;
-TimeSeriesExport<int> totalHouseholdContacts;
-TimeSeriesExport<int> totalHouseholdContactsUnder5;
-
-PyramidTimeSeriesExport pyramid;
-PyramidTimeSeriesExport deathPyramid;
-PyramidTimeSeriesExport hivInfectionsPyramid;
-PyramidTimeSeriesExport hivPositivePyramid;
-PyramidTimeSeriesExport tbExperiencedPyramid;
-
 map<TimeStatType, string> columns {
   {TimeStatType::Sum,  "Total"},
     {TimeStatType::Mean, "Average"},
@@ -110,179 +56,6 @@ map<TimeStatType, string> columns {
 };
 
 
-bool ExportTrajectory(TBABM& t, 
-    std::uint_fast64_t i, 
-    std::shared_ptr<ofstream> populationSurvey, 
-    std::shared_ptr<ofstream> householdSurvey, 
-    std::shared_ptr<ofstream> deathSurvey,
-    std::shared_ptr<ofstream> ctInfectiousnessAverted)
-{
-  bool success {true};
-  long id {static_cast<long>(i)};
-
-  auto data = t.GetData();
-
-  for (auto&& x : indexed(data.ctInfectiousnessAverted, coverage::all)) {
-    *ctInfectiousnessAverted << boost::format("%i,%.1f,%.1f,%i\n")
-      % id % x.bin().lower() % x.bin().upper() % *x;
-  }
-
-  std::cout << std::flush;
-
-  success &= births.Add(                 std::move(std::make_shared<decltype(data.births)>(data.births)), id);
-  success &= deaths.Add(                 std::move(std::make_shared<decltype(data.deaths)>(data.deaths)), id);
-  success &= marriages.Add(              std::move(std::make_shared<decltype(data.marriages)>(data.marriages)), id);
-  success &= divorces.Add(               std::move(std::make_shared<decltype(data.divorces)>(data.divorces)), id);
-  success &= households.Add(             std::move(std::make_shared<decltype(data.householdsCount)>(data.householdsCount)), id);
-  success &= singleToLooking.Add(        std::move(std::make_shared<decltype(data.singleToLooking)>(data.singleToLooking)), id);
-
-  success &= populationSize.Add(         std::move(std::make_shared<decltype(data.populationSize)>(data.populationSize)), id);
-  success &= populationChildren.Add(     std::move(std::make_shared<decltype(data.populationChildren)>(data.populationChildren)), id);
-  success &= populationAdults.Add(       std::move(std::make_shared<decltype(data.populationAdults)>(data.populationAdults)), id);
-
-  success &= hivNegative.Add(            std::move(std::make_shared<decltype(data.hivNegative)>(data.hivNegative)), id);
-  success &= hivPositive.Add(            std::move(std::make_shared<decltype(data.hivPositive)>(data.hivPositive)), id);
-  success &= hivPositiveART.Add(         std::move(std::make_shared<decltype(data.hivPositiveART)>(data.hivPositiveART)), id);
-  success &= hivInfections.Add(          std::move(std::make_shared<decltype(data.hivInfections)>(data.hivInfections)), id);
-  success &= hivDiagnosed.Add(           std::move(std::make_shared<decltype(data.hivDiagnosed)>(data.hivDiagnosed)), id);
-  success &= hivDiagnosedVCT.Add(        std::move(std::make_shared<decltype(data.hivDiagnosedVCT)>(data.hivDiagnosedVCT)), id);
-  success &= hivDiagnosesVCT.Add(        std::move(std::make_shared<decltype(data.hivDiagnosesVCT)>(data.hivDiagnosesVCT)), id);
-  success &= tbInfections.Add(           std::move(std::make_shared<decltype(data.tbInfections)>(data.tbInfections)), id);
-  success &= tbIncidence.Add(            std::move(std::make_shared<decltype(data.tbIncidence)>(data.tbIncidence)), id);
-  success &= tbRecoveries.Add(           std::move(std::make_shared<decltype(data.tbRecoveries)>(data.tbRecoveries)), id);
-  success &= tbInfectionsHousehold.Add(  std::move(std::make_shared<decltype(data.tbInfectionsHousehold)>(data.tbInfectionsHousehold)), id);
-  success &= tbInfectionsCommunity.Add(  std::move(std::make_shared<decltype(data.tbInfectionsCommunity)>(data.tbInfectionsCommunity)), id);
-  success &= tbSusceptible.Add(          std::move(std::make_shared<decltype(data.tbSusceptible)>(data.tbSusceptible)), id);
-  success &= tbLatent.Add(               std::move(std::make_shared<decltype(data.tbLatent)>(data.tbLatent)), id);
-  success &= tbInfectious.Add(           std::move(std::make_shared<decltype(data.tbInfectious)>(data.tbInfectious)), id);
-  success &= tbExperienced.Add(		   std::move(std::make_shared<decltype(data.tbExperienced)>(data.tbExperienced)), id);
-  success &= tbTreatmentBegin.Add(       std::move(std::make_shared<decltype(data.tbTreatmentBegin)>(data.tbTreatmentBegin)), id);
-  success &= tbTreatmentBeginHIV.Add(    std::move(std::make_shared<decltype(data.tbTreatmentBeginHIV)>(data.tbTreatmentBeginHIV)), id);
-  success &= tbTreatmentBeginChildren.Add(    std::move(std::make_shared<decltype(data.tbTreatmentBeginChildren)>(data.tbTreatmentBeginChildren)), id);
-  success &= tbTreatmentBeginAdultsNaive.Add(    std::move(std::make_shared<decltype(data.tbTreatmentBeginAdultsNaive)>(data.tbTreatmentBeginAdultsNaive)), id);
-  success &= tbTreatmentBeginAdultsExperienced.Add(    std::move(std::make_shared<decltype(data.tbTreatmentBeginAdultsExperienced)>(data.tbTreatmentBeginAdultsExperienced)), id);
-  success &= tbTreatmentEnd.Add(         std::move(std::make_shared<decltype(data.tbTreatmentEnd)>(data.tbTreatmentEnd)), id);
-  success &= tbTreatmentDropout.Add(     std::move(std::make_shared<decltype(data.tbTreatmentDropout)>(data.tbTreatmentDropout)), id);
-  success &= tbInTreatment.Add(          std::move(std::make_shared<decltype(data.tbInTreatment)>(data.tbInTreatment)), id);
-  success &= tbCompletedTreatment.Add(   std::move(std::make_shared<decltype(data.tbCompletedTreatment)>(data.tbCompletedTreatment)), id);
-  success &= tbDroppedTreatment.Add(     std::move(std::make_shared<decltype(data.tbDroppedTreatment)>(data.tbDroppedTreatment)), id);
-  success &= pyramid.Add(                std::move(std::make_shared<decltype(data.pyramid)>(data.pyramid)), id);
-  success &= deathPyramid.Add(           std::move(std::make_shared<decltype(data.deathPyramid)>(data.deathPyramid)), id);
-  success &= hivInfectionsPyramid.Add(   std::move(std::make_shared<decltype(data.hivInfectionsPyramid)>(data.hivInfectionsPyramid)), id);
-  success &= hivPositivePyramid.Add(     std::move(std::make_shared<decltype(data.hivPositivePyramid)>(data.hivPositivePyramid)), id);
-  success &= tbExperiencedPyramid.Add(   std::move(std::make_shared<decltype(data.tbExperiencedPyr)>(data.tbExperiencedPyr)), id);
-
-  success &= tbDeaths.Add(   std::move(std::make_shared<decltype(data.tbDeaths)>(data.tbDeaths)), id);
-  success &= tbDeathsHIV.Add(   std::move(std::make_shared<decltype(data.tbDeathsHIV)>(data.tbDeathsHIV)), id);
-  success &= tbDeathsUnderFive.Add(   std::move(std::make_shared<decltype(data.tbDeathsUnderFive)>(data.tbDeathsUnderFive)), id);
-
-  success &= ctHomeVisits.Add(std::move(           std::make_shared<decltype(data.ctHomeVisits)>(data.ctHomeVisits)), id);
-  success &= ctScreenings.Add(std::move(           std::make_shared<decltype(data.ctScreenings)>(data.ctScreenings)), id);
-  success &= ctScreeningsHIV.Add(std::move(        std::make_shared<decltype(data.ctScreeningsHIV)>(data.ctScreeningsHIV)), id);
-  success &= ctScreeningsChildren.Add(std::move(   std::make_shared<decltype(data.ctScreeningsChildren)>(data.ctScreeningsChildren)), id);
-  success &= ctCasesFound.Add(std::move(           std::make_shared<decltype(data.ctCasesFound)>(data.ctCasesFound)), id);
-  success &= ctCasesFoundHIV.Add(std::move(        std::make_shared<decltype(data.ctCasesFoundHIV)>(data.ctCasesFoundHIV)), id);
-  success &= ctCasesFoundChildren.Add(std::move(   std::make_shared<decltype(data.ctCasesFoundChildren)>(data.ctCasesFoundChildren)), id);
-  success &= ctDeathsAverted.Add(std::move(        std::make_shared<decltype(data.ctDeathsAverted)>(data.ctDeathsAverted)), id);
-  success &= ctDeathsAvertedHIV.Add(std::move(     std::make_shared<decltype(data.ctDeathsAvertedHIV)>(data.ctDeathsAvertedHIV)), id);
-  success &= ctDeathsAvertedChildren.Add(std::move(std::make_shared<decltype(data.ctDeathsAvertedChildren)>(data.ctDeathsAvertedChildren)), id);
-
-  success &= tbTxExperiencedAdults.Add(               std::move(std::make_shared<decltype(data.tbTxExperiencedAdults)>(data.tbTxExperiencedAdults)), id);
-  success &= tbTxExperiencedInfectiousAdults.Add(     std::move(std::make_shared<decltype(data.tbTxExperiencedInfectiousAdults)>(data.tbTxExperiencedInfectiousAdults)), id);
-  success &= tbTxNaiveAdults.Add(                     std::move(std::make_shared<decltype(data.tbTxNaiveAdults)>(data.tbTxNaiveAdults)), id);
-  success &= tbTxNaiveInfectiousAdults.Add(           std::move(std::make_shared<decltype(data.tbTxNaiveInfectiousAdults)>(data.tbTxNaiveInfectiousAdults)), id);
-
-  success &= activeHouseholdContacts.Add(std::move(std::make_shared<decltype(data.activeHouseholdContacts)>(data.activeHouseholdContacts)), id);
-  success &= activeHouseholdContactsUnder5.Add(std::move(std::make_shared<decltype(data.activeHouseholdContactsUnder5)>(data.activeHouseholdContactsUnder5)), id);
-  success &= totalHouseholdContacts.Add(std::move(std::make_shared<decltype(data.totalHouseholdContacts)>(data.totalHouseholdContacts)), id);
-  success &= totalHouseholdContactsUnder5.Add(std::move(std::make_shared<decltype(data.totalHouseholdContactsUnder5)>(data.totalHouseholdContactsUnder5)), id);
-
-  success &= t.WriteSurveys(populationSurvey, householdSurvey, deathSurvey);
-
-  return success;
-}
-
-bool WriteData(string outputPrefix)
-{
-  return (
-      births.Write(outputPrefix + "births.csv")               &&                                             
-      deaths.Write(outputPrefix + "deaths.csv")               &&                                             
-      marriages.Write(outputPrefix + "marriages.csv")            &&                                    
-      divorces.Write(outputPrefix + "divorces.csv")             &&                                       
-      singleToLooking.Write(outputPrefix + "singleToLooking.csv")      &&                  
-
-      populationSize.Write(outputPrefix + "populationSize.csv")       &&                     
-      populationChildren.Write(outputPrefix + "populationChildren.csv")       &&                     
-      populationAdults.Write(outputPrefix + "populationAdults.csv")       &&                     
-
-      pyramid.Write(outputPrefix + "pyramid.csv")              &&                                          
-      deathPyramid.Write(outputPrefix + "deathPyramid.csv")         &&                           
-      households.Write(outputPrefix + "households.csv")           &&                                 
-
-      hivInfectionsPyramid.Write(outputPrefix + "hivInfectionsPyramid.csv") &&   
-      hivPositivePyramid.Write(outputPrefix + "hivPositivePyramid.csv")   &&         
-      hivNegative.Write(outputPrefix + "hivNegative.csv")          &&                              
-      hivPositive.Write(outputPrefix + "hivPositive.csv")          &&                              
-      hivPositiveART.Write(outputPrefix + "hivPositiveART.csv")       &&                     
-      hivInfections.Write(outputPrefix + "hivInfections.csv")        &&                        
-      hivDiagnosed.Write(outputPrefix + "hivDiagnosed.csv")         &&                           
-      hivDiagnosedVCT.Write(outputPrefix + "hivDiagnosedVCT.csv")      &&                  
-      hivDiagnosesVCT.Write(outputPrefix + "hivDiagnosesVCT.csv")      &&                  
-
-      tbInfections.Write(outputPrefix + "tbInfections.csv")         &&                           
-      tbIncidence.Write(outputPrefix + "tbIncidence.csv")        &&                        
-      tbRecoveries.Write(outputPrefix + "tbRecoveries.csv")         &&                           
-
-      tbInfectionsHousehold.Write(outputPrefix + "tbInfectionsHousehold.csv")&&
-      tbInfectionsCommunity.Write(outputPrefix + "tbInfectionsCommunity.csv")&&
-
-      tbSusceptible.Write(outputPrefix + "tbSusceptible.csv")        &&                        
-      tbLatent.Write(outputPrefix + "tbLatent.csv")             &&                                       
-      tbInfectious.Write(outputPrefix + "tbInfectious.csv")         &&                           
-
-      tbExperienced.Write(outputPrefix + "tbExperienced.csv") &&
-
-      tbTreatmentBegin.Write(outputPrefix + "tbTreatmentBegin.csv")     &&               
-      tbTreatmentBeginHIV.Write(outputPrefix + "tbTreatmentBeginHIV.csv")  &&
-      tbTreatmentBeginChildren.Write(outputPrefix + "tbTreatmentBeginChildren.csv")  &&
-      tbTreatmentBeginAdultsNaive.Write(outputPrefix + "tbTreatmentBeginAdultsNaive.csv")  &&
-      tbTreatmentBeginAdultsExperienced.Write(outputPrefix + "tbTreatmentBeginAdultsExperienced.csv")  &&       
-
-      tbTreatmentEnd.Write(outputPrefix + "tbTreatmentEnd.csv")       &&                     
-      tbTreatmentDropout.Write(outputPrefix + "tbTreatmentDropout.csv")   &&         
-      tbInTreatment.Write(outputPrefix + "tbInTreatment.csv")        &&                        
-      tbCompletedTreatment.Write(outputPrefix + "tbCompletedTreatment.csv") &&   
-      tbDroppedTreatment.Write(outputPrefix + "tbDroppedTreatment.csv")   &&   
-
-      tbExperiencedPyramid.Write(outputPrefix + "tbExperiencedPyramid.csv") &&
-
-      tbDeaths.Write(outputPrefix + "tbDeaths.csv")   &&   
-      tbDeathsHIV.Write(outputPrefix + "tbDeathsHIV.csv")   &&   
-      tbDeathsUnderFive.Write(outputPrefix + "tbDeathsUnderFive.csv")   &&   
-
-      ctHomeVisits.Write(outputPrefix + "ctHomeVisits.csv") &&
-      ctScreenings.Write(outputPrefix + "ctScreenings.csv") &&
-      ctScreeningsHIV.Write(outputPrefix + "ctScreeningsHIV.csv") &&
-      ctScreeningsChildren.Write(outputPrefix + "ctScreeningsChildren.csv") &&
-      ctCasesFound.Write(outputPrefix + "ctCasesFound.csv") &&
-      ctCasesFoundHIV.Write(outputPrefix + "ctCasesFoundHIV.csv") &&
-      ctCasesFoundChildren.Write(outputPrefix + "ctCasesFoundChildren.csv") &&
-      ctDeathsAverted.Write(outputPrefix + "ctDeathsAverted.csv") &&
-      ctDeathsAvertedHIV.Write(outputPrefix + "ctDeathsAvertedHIV.csv") &&
-      ctDeathsAvertedChildren.Write(outputPrefix + "ctDeathsAvertedChildren.csv") &&
-
-      tbTxExperiencedAdults.Write(outputPrefix + "tbTxExperiencedAdults.csv") &&
-      tbTxExperiencedInfectiousAdults.Write(outputPrefix + "tbTxExperiencedInfectiousAdults.csv") &&
-      tbTxNaiveAdults.Write(outputPrefix + "tbTxNaiveAdults.csv") &&
-      tbTxNaiveInfectiousAdults.Write(outputPrefix + "tbTxNaiveInfectiousAdults.csv") &&
-
-      activeHouseholdContacts.Write(outputPrefix + "activeHouseholdContacts.csv") &&
-      activeHouseholdContactsUnder5.Write(outputPrefix + "activeHouseholdContactsUnder5.csv") &&
-      totalHouseholdContacts.Write(outputPrefix + "totalHouseholdContacts.csv") &&
-      totalHouseholdContactsUnder5.Write(outputPrefix + "totalHouseholdContactsUnder5.csv")
-      );
-}
-
 bool householdsFileValid(const string& fname)
 {
   struct stat buf;
@@ -298,12 +71,44 @@ Usage:
 Options:
   -t NUM     Number of trajectories to run.
   -n NUM     Initial approximate size of population.
-  -p PATH    Path to the parameter file [default: sampleParams.json]
+  -p PATH    Path to the parameter file (.json, or .csv as in
+             params/runsheet_prototype.csv), or 'bundle.bin#k' for run k of
+             a runsheet bundle (see BundleRunsheets) [default: sampleParams.json]
   -y NUM     Years to simulate [default: 50]
   -s NUM     Seed of the master PRNG. Default is system time
   -o PATH    Dir for outputs. Include trailing slash. [default: .]
+  --format=(csv|columnar)  Form of the outputs. 'columnar' replaces each
+             CSV, once written, with a typed, compressed binary file of the
+             same columns, <name>.tbc; ConvertOutputs turns one back into
+             CSV, and viz/R/utils_columnar.R reads them. [default: csv]
+  --sqlite=PATH  Also load each set of outputs, as it is written, into the
+             SQLite database PATH, with the job it came from and its
+             runsheet's parameters, in place of DumpToDB. PATH is created
+             if need be; jobs are added to what is there. Loading holds
+             up the writer thread, and so, once its queue is full, the
+             trajectories finishing meanwhile. Not with --processes or
+             --checkpoint.
   -m NUM     Size of threadpool [default: 1]
-  -h PATH    Location of households file. [default: household_structure.csv]
+  --pin      Pin each thread of the pool to its own CPU, of those the
+             process may run on. Worker processes each take the next -m.
+  --init-threads=NUM  Threads each trajectory draws its initial population's
+             first events on. Results don't depend on it. Only used
+             while timeToLookingScale is a Constant. [default: 1]
+  --init-chunk=NUM  Individuals per chunk of those draws; each chunk has an
+             RNG stream of its own, so results do depend on it.
+             [default: 4096]
+  --memory=SIZE  Memory trajectories may take, e.g. '64G'. A trajectory
+             only starts once it is expected to fit. Default is 90% of the
+             least of the cgroup's limit, ulimit -v and -d, and physical
+             memory. With --processes, it is split evenly between them.
+  --bytes-per-agent-year=NUM  What a trajectory is expected to take per
+             agent of -n per year of -y, until one has been measured
+             [default: 80]
+  --timings=PATH  File of prior trajectory timings. Trajectories expected
+             to take longest are started first, and the time each one
+             takes is appended to PATH.
+  -h PATH    Location of households file: a CSV, or its compiled form from
+             CompileHouseholds. [default: household_structure.csv]
   --ctrace=(none|vul|ivul|prob)  Type of contact tracing to perform
 
     prob: Trace households that "can" be reached. "can" is probabilistically
@@ -312,11 +117,84 @@ Options:
     vul:  Same as 'prob', but household must have a vulnerable individual.
           This vulnerable individual could be the index case.
 
+  --sweep=PATH  Generate a sweep from the range file PATH, rather than use
+                the runsheet as-is. PATH is a CSV with columns name, lower,
+                upper and step (or name, min, max); each 'name' is the
+                short-name of a row of the runsheet whose 'parameter-1' is
+                varied.
+  --design=(grid|lhs|sobol)  How the sweep samples its ranges. 'grid'
+                crosses seq(lower, upper, step) of each range, as
+                gen_runsheets.R -r does. 'lhs' (Latin hypercube) and
+                'sobol' draw --runs points from [lower, upper]. [default: grid]
+  --runs=NUM    Number of parameter sets in an lhs or sobol sweep [default: 1]
+  --sweep-seed=NUM  Seed of an lhs or sobol sweep [default: 1]
+  --sweep-run=NUM   Parameter set of the sweep to run, from 0 [default: 0]
+  --emit-bundle=PATH  Write every parameter set of the sweep to the runsheet
+                bundle PATH, then exit, without running anything.
+
+  --batch=PATH  Run every runsheet listed in PATH (or on stdin, if PATH is
+                '-'), one per line, in any form -p accepts; a bundle without
+                '#k' stands for all of its runs. Each gets -t trajectories,
+                and its outputs go in <-o>/<n>/, where n counts runsheets
+                from 1, as RunTBABM lays them out.
+  --combined    With --batch, write the outputs of every runsheet to one set
+                in -o instead. 'jobs.csv' maps each trajectory to its
+                runsheet either way.
+  --lookahead=NUM  With --batch or --serve, how many runsheets may be on
+                the pool at once. The next is loaded while they run.
+                [default: 2]
+
+  --serve=PATH  Stay resident, running jobs as they arrive on PATH (a file
+                or FIFO, or '-' for stdin), one per line, until it ends; a
+                FIFO is reopened when its writer closes it. A job is a
+                runsheet as for --batch, or a JSON object such as
+                  {"id": "a1", "runsheet": "x.json", "set": {"TB_beta": 0.3},
+                   "seed": 12, "trajectories": 4, "output": "out/a1/"}
+                where "runsheet" may also be an inline array of rows, and
+                all but it are optional. Outputs go in <-o>/<id>/ by
+                default, with ids counting jobs from 1. Household templates
+                and frames stay loaded between jobs.
+  --adaptive=TARGETS  Run each job until the Monte Carlo standard error of
+                every target is within --tolerance, between
+                --min-trajectories and -t trajectories. TARGETS is a
+                comma-separated list of 'series[/series][@from[-to]]': the
+                mean of an output time series over the years from-to (all
+                years, if omitted), optionally divided by another series,
+                e.g. 'tbIncidence@2005-2015,hivPositive/populationSize@2010'.
+                The rule is applied to trajectories in seed order, however
+                they finish, so the count is the same for any -m; those
+                run past where it stops are left out of the outputs.
+  --tolerance=NUM  Largest standard error --adaptive accepts; with a '%'
+                suffix, relative to the target's mean. [default: 5%]
+  --min-trajectories=NUM  Fewest trajectories --adaptive runs. [default: 4]
+
+  --processes=NUM  Run as NUM worker processes, each with a pool of -m
+                threads, that share the loaded inputs and claim
+                trajectories from a table in shared memory. Their outputs
+                are merged into one set, as if from a single process. Not
+                with --serve or --adaptive. [default: 1]
+
+  --checkpoint=DIR  Save each trajectory to DIR as it finishes. If the run
+                is killed, or stopped with SIGTERM, starting it again with
+                the same arguments carries on from there; trajectories that
+                were in flight are run again from their seeds. Stopping it
+                with SIGTERM or SIGINT records those in DIR/in-flight.csv,
+                and they are then run first. Outputs are written once every
+                job is done, and DIR is then removed. A run resumed keeps
+                the seed it was started with; it is an error to give it
+                another with -s. Not with --serve or --processes.
+
+  --done=PATH   Where --serve writes a line of JSON as each job finishes
+                or is rejected. [default: stdout]
+
+  --legacy-rng  Sample Bernoulli(0) and Bernoulli(1) parameters rather than
+                folding them to constants. Each sample draws from the RNG, so
+                this reproduces the RNG stream (and results) of older runs.
+                'Constant' parameters are folded regardless; they never draw.
+
   --version  Print version
 )";
 
-CTraceType trace_kind = CTraceType::None;
-
 int main(int argc, char **argv)
 {
   std::map<std::string, docopt::value> args
@@ -325,25 +203,49 @@ int main(int argc, char **argv)
                      true,           // show help if requested
                      "TBABM 0.7.1"); // version string
 
-  Constants constants {};
-
   // Initialize some constants that will be passed to each trajectory
-  constants["tMax"]           = 365*50;
-  constants["periodLength"]   = 365;
-  constants["ageGroupWidth"]  = 3;
-  constants["startYear"]      = 1990;
-  constants["populationSize"] = 10000;
+  Constants constants = Model::DefaultConstants(10000, 50);
 
   // Initialize a few default values for parameters that mostly can be 
   // passed through the command line
   string householdsFile {"household_structure.csv"};
   int nTrajectories {1};
   auto timestamp = static_cast<std::uint_fast64_t>(std::time(NULL));
+  bool seed_given {false};
 
   string folder {""};
+  bool columnar {false};
+  string database_file {""};
   string parameter_sheet {"sampleParams.json"};
 
   int pool_size {1};
+  bool pin {false};
+  std::size_t memory_budget {0};
+  double bytes_per_agent_year {80};
+  string timings_file {""};
+
+  bool legacy_rng {false};
+
+  string adaptive_targets {""};
+  double tolerance {0.05};
+  bool relative_tolerance {true};
+  int min_trajectories {4};
+
+  int processes {1};
+  string checkpoint_dir {""};
+
+  string batch_file {""};
+  string serve_file {""};
+  string done_path {""};
+  bool combined {false};
+  int lookahead {2};
+
+  string sweep_file {""};
+  string bundle_out {""};
+  auto design = Sweep::Design::Grid;
+  std::uint32_t sweep_runs {1};
+  std::uint64_t sweep_seed {1};
+  std::uint32_t sweep_run {0};
 
   for (auto const& arg : args) {
     if (arg.first == "-h")
@@ -354,14 +256,87 @@ int main(int argc, char **argv)
       constants["populationSize"] = static_cast<int>(arg.second.asLong());
     else if (arg.first == "-p")
       parameter_sheet = arg.second.asString();
+    else if (arg.first == "--init-threads")
+      constants["initThreads"] = std::max(1, static_cast<int>(arg.second.asLong()));
+    else if (arg.first == "--init-chunk")
+      constants["initChunk"] = std::max(1, static_cast<int>(arg.second.asLong()));
     else if (arg.first == "-y")
       constants["tMax"] = 365*static_cast<int>(arg.second.asLong());
-    else if (arg.first == "-s" && arg.second)
-      timestamp = static_cast<std::uint_fast64_t>(arg.second.asLong()); 
+    else if (arg.first == "-s" && arg.second) {
+      timestamp  = static_cast<std::uint_fast64_t>(arg.second.asLong()); 
+      seed_given = true;
+    }
     else if (arg.first == "-m")
       pool_size = static_cast<int>(arg.second.asLong());
     else if (arg.first == "-o")
       folder = arg.second.asString();
+    else if (arg.first == "--sqlite" && arg.second)
+      database_file = arg.second.asString();
+    else if (arg.first == "--format" && arg.second) {
+      if (arg.second.asString() == "csv")
+        columnar = false;
+      else if (arg.second.asString() == "columnar")
+        columnar = true;
+      else {
+        printf("Error: unknown output format '%s'\n", arg.second.asString().c_str());
+        exit(EXIT_FAILURE);
+      }
+    }
+    else if (arg.first == "--pin")
+      pin = arg.second && arg.second.asBool();
+    else if (arg.first == "--memory" && arg.second)
+      memory_budget = MemoryBudget::ParseSize(arg.second.asString());
+    else if (arg.first == "--bytes-per-agent-year")
+      bytes_per_agent_year = atof(arg.second.asString().c_str());
+    else if (arg.first == "--timings" && arg.second)
+      timings_file = arg.second.asString();
+    else if (arg.first == "--sweep" && arg.second)
+      sweep_file = arg.second.asString();
+    else if (arg.first == "--design" && arg.second) {
+      if (arg.second.asString() == "grid")
+        design = Sweep::Design::Grid;
+      else if (arg.second.asString() == "lhs")
+        design = Sweep::Design::LHS;
+      else if (arg.second.asString() == "sobol")
+        design = Sweep::Design::Sobol;
+      else {
+        printf("Error: unknown sweep design '%s'\n", arg.second.asString().c_str());
+        exit(EXIT_FAILURE);
+      }
+    }
+    else if (arg.first == "--runs")
+      sweep_runs = static_cast<std::uint32_t>(arg.second.asLong());
+    else if (arg.first == "--sweep-seed")
+      sweep_seed = static_cast<std::uint64_t>(arg.second.asLong());
+    else if (arg.first == "--sweep-run")
+      sweep_run = static_cast<std::uint32_t>(arg.second.asLong());
+    else if (arg.first == "--emit-bundle" && arg.second)
+      bundle_out = arg.second.asString();
+    else if (arg.first == "--batch" && arg.second)
+      batch_file = arg.second.asString();
+    else if (arg.first == "--adaptive" && arg.second)
+      adaptive_targets = arg.second.asString();
+    else if (arg.first == "--tolerance" && arg.second) {
+      auto tol = arg.second.asString();
+      relative_tolerance = !tol.empty() && tol.back() == '%';
+      tolerance = atof(tol.c_str()) / (relative_tolerance ? 100 : 1);
+    }
+    else if (arg.first == "--min-trajectories")
+      min_trajectories = std::max(2, static_cast<int>(arg.second.asLong()));
+    else if (arg.first == "--processes")
+      processes = std::max(1, static_cast<int>(arg.second.asLong()));
+    else if (arg.first == "--checkpoint" && arg.second)
+      checkpoint_dir = arg.second.asString();
+    else if (arg.first == "--serve" && arg.second)
+      serve_file = arg.second.asString();
+    else if (arg.first == "--done" && arg.second)
+      done_path = arg.second.asString();
+    else if (arg.first == "--combined")
+      combined = arg.second && arg.second.asBool();
+    else if (arg.first == "--lookahead")
+      lookahead = std::max(1, static_cast<int>(arg.second.asLong()));
+    else if (arg.first == "--legacy-rng")
+      legacy_rng = arg.second && arg.second.asBool();
     else if (arg.first == "--ctrace") {
       if (arg.second && arg.second.asString() == "none")
         trace_kind = CTraceType::None;
@@ -374,6 +349,34 @@ int main(int argc, char **argv)
     }
   }
 
+  // A run that is checkpointed is started again with the master seed it
+  // had the first time, so that its trajectories' seeds are the same
+  std::unique_ptr<Checkpoint> checkpoint {};
+
+  if (checkpoint_dir != "") {
+    if (serve_file != "" || processes > 1) {
+      printf("Error: --checkpoint can't be used with --serve or --processes\n");
+      exit(EXIT_FAILURE);
+    }
+
+    checkpoint.reset(new Checkpoint(checkpoint_dir));
+    timestamp = checkpoint->Seed(timestamp, seed_given);
+    checkpoint->HandleSignals();
+  }
+
+  // The database is only written from the writer thread, so one process
+  // has it to itself
+  std::unique_ptr<SQLiteOutputs> database {};
+
+  if (database_file != "") {
+    if (processes > 1 || checkpoint) {
+      printf("Error: --sqlite can't be used with --processes or --checkpoint\n");
+      exit(EXIT_FAILURE);
+    }
+
+    database.reset(new SQLiteOutputs(database_file));
+  }
+
   // Initialize the master RNG, and write the seed to the file "seed_log.txt"
   RNG rng(timestamp);
 
@@ -388,133 +391,360 @@ int main(int argc, char **argv)
     exit(EXIT_FAILURE);
   }
 
-  const std::map<string, string> surveyHeaders {
-    {"population", "trajectory,time,hash,age,sex,marital,household,householdHash,offspring,mom,dad,HIV,ART,CD4,TBStatus"},
-      {"household", "trajectory,time,hash,size,head,spouse,directOffspring,otherOffspring,other"},
-      {"death", "trajectory,time,hash,age,sex,cause,HIV,HIV_date,ART,ART_date,CD4,baseline_CD4"}
-  };
+  // A sweep is generated once, and substituted into every runsheet that
+  // is run. With --emit-bundle, it is written out instead.
+  std::vector<Sweep::Range> ranges {};
+  std::vector<double> sweep_values {};
 
-  std::map<string, std::shared_ptr<ofstream>> surveyFiles;
-  std::map<string, std::shared_ptr<ofstream>> histFiles;
+  if (sweep_file != "") {
+    ranges       = Sweep::ReadRanges(sweep_file.c_str());
+    sweep_values = Sweep::Generate(design, ranges, sweep_runs, sweep_seed);
 
-  auto prepareSurvey = [outputPrefix](std::pair<string, string> name_and_header) 
-    -> std::pair<string, std::shared_ptr<ofstream>> {
+    if (bundle_out != "") {
+      std::vector<string> names {};
+      for (auto&& r : ranges)
+        names.push_back(r.name);
 
-      // Attempt to initialize files to output surveys to
-      string fname {outputPrefix + name_and_header.first + ".csv"};
+      JobRequest prototype {};
+      json sheet {};
+      string error {};
 
-      auto temp = std::make_shared<ofstream>(fname, ios_base::out);
+      prototype.spec = parameter_sheet;
 
-      // Handle initialization failures
-      if (temp->fail()) {
-        printf("Attempt to open file '%s' failed\n", fname.c_str());
+      if (!LoadRunsheet(prototype, sheet, error)) {
+        printf("Error: %s\n", error.c_str());
         exit(EXIT_FAILURE);
       }
 
-      *temp << name_and_header.second << std::endl;
+      if (!RunsheetBundle::Write(bundle_out.c_str(), sheet, names, sweep_values))
+        exit(EXIT_FAILURE);
 
-      if (temp->fail())
-        printf("Attempt to write header to file '%s' failed\n", fname.c_str());
+      printf("Wrote %lu parameter sets to '%s'\n",
+             sweep_values.size() / ranges.size(), bundle_out.c_str());
+      exit(EXIT_SUCCESS);
+    }
+  }
 
-      return std::make_pair(name_and_header.first, temp);
-    };
+  // The household templates, and usually the frames, are the same for
+  // every runsheet of a batch, so they are loaded once and shared. Frames
+  // are kept for each set of files they've been loaded from.
+  std::shared_ptr<const HouseholdTemplates> families {};
 
-  std::transform(surveyHeaders.begin(), 
-      surveyHeaders.end(),
-      std::inserter(surveyFiles, surveyFiles.begin()),
-      prepareSurvey);
+  try {
+    families = std::make_shared<const HouseholdTemplates>(householdsFile.c_str());
+  }
+  catch (const std::exception& e) {
+    printf("Error: %s\n", e.what());
+    exit(EXIT_FAILURE);
+  }
 
-  histFiles["ctInfectiousnessAverted"] =
-    std::make_shared<ofstream>(outputPrefix + "ctInfectiousnessAverted.csv",
-                               ios_base::out);
+  Model::FrameCache frame_cache {};
 
-  *histFiles["ctInfectiousnessAverted"] << "seed,lower,upper,value" << std::endl;
+  // Reads the runsheet of 'r' into 'sheet', applies the sweep, and builds
+  // the Model all of its trajectories read it through. On failure, sets
+  // r.error and returns nullptr.
+  auto loadModel = [&ranges, &sweep_values, &sweep_file, sweep_run, &constants,
+                    &families, legacy_rng, &frame_cache]
+    (JobRequest& r, json& sheet) -> std::shared_ptr<const Model> {
+    if (r.error != "" || !LoadRunsheet(r, sheet, r.error))
+      return nullptr;
 
-  // Initialize the map of simulation parameters
-  std::map<string, Param> params{};
-  mapShortNames( fileToJSON(parameter_sheet), params );
+    try {
+      if (sweep_file != "")
+        Sweep::Apply(sheet, ranges, sweep_values, sweep_run);
 
-  // Thread pool for trajectories, and associated futures
-  ThreadPool pool(pool_size);
-  vector<future<bool>> results;
+      return std::make_shared<const Model>(sheet, constants, families, legacy_rng, &frame_cache);
+    }
+    catch (const std::exception& e) {
+      r.error = e.what();
+      return nullptr;
+    }
+  };
 
-  // Mutex lock for data-export critical section
-  std::mutex mtx;
+  // Jobs to run: the runsheet given by -p, or every one from --batch or
+  // --serve
+  bool serving {serve_file != ""};
+
+  std::unique_ptr<JobSource> jobs {};
+  if (serving)
+    jobs.reset(new JobSource(serve_file, true));
+  else if (batch_file != "")
+    jobs.reset(new JobSource(batch_file, false));
+
+  // With --processes, the jobs are read up front, so that every worker
+  // runs the same jobs in the same order, and can claim trajectories from
+  // one table. Their Models are built before the fork, so that workers
+  // share the parameters and frames copy-on-write; after it, nothing else
+  // is shared but the table.
+  std::vector<JobRequest> queued {};
+  std::vector<std::shared_ptr<const Model>> preloaded {};
+  std::unique_ptr<Shards> shards {};
+  int shard {0};
+
+  // With more than one job, each job's outputs go in a directory of their
+  // own unless they are --combined, and 'jobs.csv' says which trajectory
+  // belongs to which job
+  bool combine_all {!jobs || (combined && !serving)};
+
+  if (processes > 1) {
+    if (serving || adaptive_targets != "") {
+      printf("Error: --processes can't be used with --serve or --adaptive\n");
+      exit(EXIT_FAILURE);
+    }
 
-  std::vector<std::uint_fast64_t> seeds;
-  for (int i = 0; i < nTrajectories; i++)
-    seeds.emplace_back(rng.mt_());
+    JobRequest r {};
+    r.spec = parameter_sheet;
 
-  printf("Finished processing arguments and initializing the pool\n");
+    if (!jobs)
+      queued.push_back(r);
+    else
+      while (jobs->Next(r))
+        queued.push_back(r);
+
+    std::size_t items {0};
+    for (auto&& q : queued)
+      items += q.trajectories > 0 ? q.trajectories : nTrajectories;
+
+    for (std::size_t k = 0; k < queued.size(); k++) {
+      auto& q = queued[k];
+      json sheet {};
+
+      if (q.id == "")
+        q.id = std::to_string(k + 1);
+
+      preloaded.push_back(loadModel(q, sheet));
+
+      if (q.error != "") {
+        printf("Error: job %s: %s\n", q.id.c_str(), q.error.c_str());
+        exit(EXIT_FAILURE);
+      }
+    }
+
+    shards.reset(new Shards(items));
+
+    bool ok;
+    shard = shards->Fork(processes, ok);
+
+    if (shard < 0) {
+      std::set<string> prefixes {outputPrefix};
+      for (auto&& q : queued)
+        if (q.output != "")
+          prefixes.insert(q.output);
 
-  for (int i = 0; i < nTrajectories; i++) {
-    results.emplace_back(
-        pool.enqueue([i, &params, constants, 
-                      householdsFile, seeds, &mtx,
-                      &surveyFiles, &histFiles] {
-          printf("#%4d RUNNING\n", i);
-
-          // Initialize a trajectory
-          auto seed = seeds[i];
-          auto traj = TBABM(params, 
-              constants, 
-              householdsFile.c_str(), 
-              seeds[i]);
-
-          // Run the trajectory and check its' status
-          if (!traj.Run()) {
-          printf("Trajectory %4d: Run() failed\n", i);
-          return false;
-          }
-
-          // Acquire a mutex lock for the data-exporting critical section
-          mtx.lock();
-
-          // Pass the TBABM object to a function that will export its data
-          if (!ExportTrajectory(traj, 
-                seed,
-                surveyFiles.at("population"),
-                surveyFiles.at("household"),
-                surveyFiles.at("death"),
-                histFiles.at("ctInfectiousnessAverted"))) {
-
-            printf("Trajectory #%4d: ExportTrajectrory(1) failed\n", i);
-            mtx.unlock();
-            return false;
-          }
-
-          // Release the mutex lock and return
-          mtx.unlock();
-
-          // printf("#%4d FINISHED\n", i);
-          return true;
-        })
-    );
+      for (auto&& prefix : prefixes)
+        ok &= Shards::Merge(prefix, processes);
+
+      // Only once merged are the outputs made columnar. Each job's are
+      // where its workers put them.
+      if (ok && columnar) {
+        for (std::size_t k = 0; k < queued.size(); k++)
+          if (queued[k].output == "" && !combine_all)
+            prefixes.insert(outputPrefix + (queued[k].id != "" ? queued[k].id : std::to_string(k + 1)) + "/");
+
+        for (auto&& prefix : prefixes)
+          ok &= RunOutputs::ToColumnar(prefix);
+      }
+
+      if (!ok) {
+        printf("A worker process failed. Exiting\n");
+        exit(1);
+      }
+
+      return 0;
+    }
+
+    outputPrefix += Shards::Dir(shard);
+    mkdir(outputPrefix.c_str(), S_IRWXU);
+
+    for (auto&& q : queued)
+      if (q.output != "") {
+        mkdir(q.output.c_str(), S_IRWXU);
+        q.output += Shards::Dir(shard);
+      }
   }
 
-  // Barrier: Wait for each thread to return successfully or unsuccessfully
-  // for (auto && result : results)
-  // std::cout << result.get() << ' ';
-  for (int i = 0; i < nTrajectories; i++) {
-    printf("#%4d JOINED: %d\n", i, (int)results[i].get());
+  // Under --checkpoint, nothing is written to the outputs until every job
+  // is done.
+  std::shared_ptr<RunOutputs> combined_outputs {};
+  if (combine_all && !checkpoint) {
+    combined_outputs = std::make_shared<RunOutputs>(outputPrefix);
+
+    if (!combined_outputs->Ok()) {
+      printf("Error: could not open the outputs under '%s'\n", outputPrefix.c_str());
+      exit(EXIT_FAILURE);
+    }
   }
 
-  std::cout << std::endl;
+  // While serving, every job gets a completion line
+  FILE *done_file {stdout};
+  std::mutex done_mutex;
 
-  if (!WriteData(outputPrefix)) {
-    printf("WriteData() failed. Exiting\n");
-    exit(1);
+  if (serving && done_path != "" && !(done_file = fopen(done_path.c_str(), "a"))) {
+    printf("Error: could not open '%s'\n", done_path.c_str());
+    exit(EXIT_FAILURE);
   }
 
-  for (auto && file : surveyFiles) {
-    file.second->flush();
-    file.second->close();
+  auto reportDone = [serving, done_file, &done_mutex](const json& line) {
+    if (!serving)
+      return;
+
+    std::lock_guard<std::mutex> lock(done_mutex);
+    fprintf(done_file, "%s\n", line.dump().c_str());
+    fflush(done_file);
+  };
+
+  // Trajectories are admitted to run while they are expected to fit in
+  // memory, however many threads are free. Worker processes share the
+  // node's memory, and each only sees its own resident set, so each is
+  // given its share of the budget.
+  if (processes > 1)
+    memory_budget = (memory_budget > 0 ? memory_budget : MemoryBudget::Limit() / 10 * 9) / processes;
+
+  // Under --adaptive, -t is the most trajectories a job may run, and it
+  // stops launching them once every target is within tolerance
+  std::vector<Target> targets {};
+  if (adaptive_targets != "")
+    targets = ParseTargets(adaptive_targets,
+                           constants["startYear"],
+                           constants["tMax"] / constants["periodLength"]);
+
+  JobRunner::Options options {};
+  options.pool_size            = pool_size;
+  options.pin                  = pin;
+  options.first_cpu            = static_cast<std::size_t>(shard) * pool_size;
+  options.memory_budget        = memory_budget;
+  options.bytes_per_agent_year = bytes_per_agent_year;
+  options.timings_file         = timings_file;
+  options.targets              = targets;
+  options.min_trajectories     = min_trajectories;
+  options.tolerance            = tolerance;
+  options.relative_tolerance   = relative_tolerance;
+  options.lookahead            = lookahead;
+  options.columnar             = columnar;
+  options.jobs_csv             = jobs ? outputPrefix + "jobs.csv" : "";
+
+  JobRunner runner(options, checkpoint.get(), database.get(), shards.get(),
+                   reportDone, combined_outputs, outputPrefix);
+
+  printf("Finished processing arguments and initializing the pool\n");
+
+  JobRequest request {};
+  request.spec = parameter_sheet;
+
+  std::size_t next_queued {0};
+  std::size_t next_item {0};
+
+  auto nextJob = [&jobs, &queued, &shards, &next_queued](JobRequest& r, int n) {
+    if (shards) {
+      if (next_queued == queued.size())
+        return false;
+
+      r = queued[next_queued++];
+      return true;
+    }
+
+    return jobs ? jobs->Next(r) : n == 1;
+  };
+
+  bool outputs_failed {false};
+
+  for (int n = 1; nextJob(request, n); n++) {
+    if (request.id == "")
+      request.id = std::to_string(n);
+
+    // All trajectories of this runsheet read it through the same Model,
+    // which lives until the last of them finishes. Building it is where a
+    // runsheet turns out to be unusable.
+    json sheet {};
+    auto model = shards ? preloaded[next_queued - 1] : loadModel(request, sheet);
+
+    // A server turns bad jobs away; anything else stops at the first one
+    if (request.error != "") {
+      if (!serving) {
+        printf("Error: job %s: %s\n", request.id.c_str(), request.error.c_str());
+        exit(EXIT_FAILURE);
+      }
+
+      reportDone({{"id", request.id}, {"status", "rejected"}, {"error", request.error}});
+      continue;
+    }
+
+    JobRunner::JobSpec job {};
+    job.id    = request.id;
+    job.spec  = request.sheet.is_null() ? request.spec : "<inline>";
+    job.model = model;
+
+    if (request.output != "")
+      job.prefix = request.output;
+    else if (combine_all)
+      job.prefix = outputPrefix;
+    else
+      job.prefix = outputPrefix + job.id + "/";
+
+    mkdir(job.prefix.c_str(), S_IRWXU);
+
+    if (!checkpoint)
+      job.outputs = request.output == "" && combine_all ? combined_outputs : \
+                    std::make_shared<RunOutputs>(job.prefix);
+
+    // Jobs already on the pool still finish and are written before this
+    // one is given up on
+    if (job.outputs && !job.outputs->Ok()) {
+      string error {"could not open its outputs under '" + job.prefix + "'"};
+
+      if (!serving) {
+        printf("Error: job %s: %s\n", job.id.c_str(), error.c_str());
+        outputs_failed = true;
+        break;
+      }
+
+      reportDone({{"id", job.id}, {"status", "rejected"}, {"error", error}});
+      continue;
+    }
+
+    // Trajectories are ordered longest-expected-first. Without a prior timing
+    // of this runsheet, population size times duration stands in for cost.
+    job.timings_key = job.spec + \
+                      (request.set.is_null() ? "" : request.set.dump()) + \
+                      (sweep_file != "" ? "@" + sweep_file + "#" + std::to_string(sweep_run) : "") + \
+                      ";n=" + std::to_string((int)constants["populationSize"]) + \
+                      ";t=" + std::to_string((int)constants["tMax"]);
+
+    job.cost = constants["populationSize"] * constants["tMax"];
+
+    // A job with a seed of its own draws its trajectories' seeds from it,
+    // so it is reproducible regardless of what else the process has run
+    RNG job_rng(request.seed);
+    RNG& seed_rng = request.has_seed ? job_rng : rng;
+
+    job.seed = request.has_seed ? request.seed : timestamp;
+
+    if (database)
+      job.sheet = sheet;
+
+    int trajectories = request.trajectories > 0 ? request.trajectories : nTrajectories;
+
+    if (trajectories == 0) {
+      printf("Error: job %s runs no trajectories\n", job.id.c_str());
+      exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < trajectories; i++)
+      job.seeds.emplace_back(seed_rng.mt_());
+
+    job.first_item = next_item;
+    next_item     += trajectories;
+
+    runner.Submit(std::move(job));
   }
 
-  for (auto&& file : histFiles) {
-    file.second->flush();
-    file.second->close();
+  if (!runner.Finish()) {
+    printf("WriteData() failed. Exiting\n");
+    exit(1);
   }
 
+  if (outputs_failed)
+    exit(EXIT_FAILURE);
+
   return 0;
 }
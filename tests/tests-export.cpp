@@ -0,0 +1,94 @@
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+
+#include <stdlib.h>
+
+#include "catch.hpp"
+
+#include "../include/TBABM/RunOutputs.h"
+
+// Every allocation of the test binary goes through here, and is counted
+// while 'counting' is set
+namespace {
+
+std::atomic<bool> counting {false};
+std::atomic<std::size_t> allocated {0};
+
+// Bytes allocated while 'f' runs
+template <typename F>
+std::size_t bytesAllocated(F f)
+{
+  allocated = 0;
+  counting  = true;
+  f();
+  counting  = false;
+
+  return allocated;
+}
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+  if (counting)
+    allocated += size;
+
+  if (void *p = malloc(size > 0 ? size : 1))
+    return p;
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, std::size_t) noexcept { free(p); }
+
+TEST_CASE("Adding a trajectory to RunOutputs doesn't copy its series", "[export]")
+{
+  char dir[] = "/tmp/tbabm-export-XXXXXX";
+  REQUIRE(mkdtemp(dir));
+
+  RunOutputs outputs(string(dir) + "/");
+
+  // A century of daily periods, so that the series are large
+  const int tMax {365 * 100};
+  std::shared_ptr<TrajectoryResult> result {};
+
+  auto held = bytesAllocated([&result, tMax] {
+    result = std::make_shared<TrajectoryResult>(
+      TrajectoryResult{1, MasterData(tMax, 1, {15, 25, 35, 45, 55, 65}), "", "", ""});
+
+    auto& data = result->data;
+
+    for (int t = 0; t < tMax; t++) {
+      data.births.Record(t, 1);
+      data.populationSize.Record(t, 1);
+      data.hivPositive.Record(t, 1);
+      data.pyramid.UpdateByAge(t, t % 2, t % 80, 1);
+    }
+
+    data.Close();
+  });
+
+  // Copying the series, as Add() once did, allocates at least as much as
+  // they hold, so that is what this test would see if it were done again
+  auto copied = bytesAllocated([&result] {
+    MasterData copy(result->data);
+  });
+
+  REQUIRE(copied >= held / 2);
+
+  auto exported = bytesAllocated([&outputs, &result] {
+    REQUIRE(outputs.Add(std::move(result)));
+  });
+
+  // What is allocated is the exporters' bookkeeping, and the histogram's
+  // formatting; nothing in proportion to the series
+  CHECK(exported < held / 20);
+
+  REQUIRE(outputs.Write());
+
+  std::system(("rm -rf " + string(dir)).c_str());
+}
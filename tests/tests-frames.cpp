@@ -0,0 +1,186 @@
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <DataFrame.h>
+#include <JSONImport.h>
+#include <RNG.h>
+
+#include "catch.hpp"
+
+#include "../include/TBABM/FrameTable.h"
+#include "../include/TBABM/utils/csv.h"
+
+using SimulationLib::DataFrameFile;
+using StatisticalDistributions::RNG;
+
+namespace {
+
+// Every frame shipped in params/, a year and sex dimension or not
+const char *frames[] = {
+  "Demographic/probability of pregnant.csv",
+  "Demographic/time in marriage.csv",
+  "Demographic/time to first birth.csv",
+  "Demographic/time to looking.csv",
+  "Demographic/time to natural death bestdata.csv",
+  "Demographic/time to natural death fixed.csv",
+  "Demographic/time to natural death newdata.csv",
+  "Demographic/time to natural death.csv",
+  "Demographic/time to subsequent births.csv",
+  "HIV/ART - TB.csv",
+  "HIV/ART - noTB.csv",
+  "HIV/VCT a_t_i.csv",
+  "HIV/VCT sig_i.csv",
+  "HIV/infection risk - nospouse.csv",
+  "HIV/infection risk - spouse.csv",
+  "HIV/prevalence - 1990.csv",
+};
+
+bool IsNumber(const string& s, double& v)
+{
+  char *end {nullptr};
+  v = std::strtod(s.c_str(), &end);
+
+  return !s.empty() && *end == '\0';
+}
+
+// The frame in 'fname' as csvjson makes the runsheets' .json files of it:
+// a column is numeric if each of its cells that isn't empty is a number,
+// and empty cells are null
+json CSVJSON(const string& fname)
+{
+  std::ifstream in(fname);
+  string line;
+
+  REQUIRE(std::getline(in, line));
+  auto header = SplitCSV(line);
+
+  std::vector<std::vector<string>> rows {};
+  while (std::getline(in, line))
+    if (line != "")
+      rows.push_back(SplitCSV(line));
+
+  std::vector<bool> numeric(header.size(), true);
+  double v;
+
+  for (auto&& row : rows)
+    for (std::size_t c = 0; c < header.size(); c++)
+      if (c < row.size() && row[c] != "" && !IsNumber(row[c], v))
+        numeric[c] = false;
+
+  json frame = json::array();
+
+  for (auto&& row : rows) {
+    json o = json::object();
+
+    for (std::size_t c = 0; c < header.size(); c++) {
+      string cell = c < row.size() ? row[c] : "";
+
+      if (cell == "")
+        o[header[c]] = nullptr;
+      else if (numeric[c] && IsNumber(cell, v))
+        o[header[c]] = v;
+      else
+        o[header[c]] = cell;
+    }
+
+    frame.push_back(o);
+  }
+
+  return frame;
+}
+
+// A cell that csvjson left as text may still hold a number
+bool Number(const json& cell, double& v)
+{
+  if (cell.is_number()) {
+    v = cell.get<double>();
+    return true;
+  }
+
+  return cell.is_string() && IsNumber(cell.get<string>(), v);
+}
+
+// The lower edge of every category of 'key', and of one past the last,
+// as the header rows and cells of 'frame' give them. Empty if the frame
+// has no such dimension.
+std::vector<double> Edges(const json& frame, const char *key)
+{
+  double width, count;
+
+  if (!Number(frame[0][key], width) || !Number(frame[1][key], count))
+    return {};
+
+  double start {INFINITY};
+  for (std::size_t i = 2; i < frame.size(); i++) {
+    double x;
+    if (Number(frame[i][key], x))
+      start = std::fmin(start, x);
+  }
+
+  std::vector<double> edges {};
+  for (int k = 0; k <= static_cast<int>(count); k++)
+    edges.push_back(start + k * width);
+
+  return edges;
+}
+
+} // namespace
+
+// CompiledFrame replaces DataFrameFile, so wherever the model may look a
+// frame up, it must give what DataFrameFile would: the same cell, drawn
+// from with the same RNG stream. That means on each side of every bin
+// edge, and clamped beyond either end.
+TEST_CASE("CompiledFrame looks up what DataFrameFile does", "[frames]")
+{
+  for (auto&& fname : frames) {
+    INFO(fname);
+
+    auto j = CSVJSON(string("../params/") + fname);
+
+    CompiledFrame compiled(j, fname);
+    DataFrameFile reference(j);
+
+    auto years = Edges(j, "year");
+    auto ages  = Edges(j, "age");
+
+    REQUIRE(ages.size() > 1);
+
+    // Without a year dimension, the year is ignored
+    std::vector<int> at_years {0, 1990};
+
+    if (!years.empty()) {
+      at_years = {static_cast<int>(years.front()) - 10,
+                  static_cast<int>(years.back()) + 10};
+
+      for (auto y : years) {
+        at_years.push_back(static_cast<int>(y) - 1);
+        at_years.push_back(static_cast<int>(y));
+      }
+    }
+
+    std::vector<double> at_ages {-1, ages.back() + 100};
+
+    for (auto a : ages) {
+      at_ages.push_back(a - 0.5);
+      at_ages.push_back(a);
+      at_ages.push_back(a + 0.5);
+    }
+
+    std::uint_fast64_t seed {1};
+
+    for (auto year : at_years)
+      for (int sex = 0; sex < 2; sex++)
+        for (auto age : at_ages) {
+          INFO("year " << year << ", sex " << sex << ", age " << age);
+
+          RNG a(seed), b(seed);
+          seed++;
+
+          REQUIRE(compiled.getValue(year, sex, age, a) == \
+                  reference.getValue(year, sex, age, b));
+        }
+  }
+}
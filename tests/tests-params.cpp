@@ -0,0 +1,23 @@
+#include <map>
+#include <string>
+
+#include <JSONParameterize.h>
+
+#include "catch.hpp"
+
+#include "../include/TBABM/ParamTable.h"
+#include "../include/TBABM/Sweep.h"
+
+using namespace SimulationLib::JSONImport;
+
+// The prototype is what the USAGE text and Sweep point users at, so it
+// must name every parameter the model requires
+TEST_CASE("The shipped runsheet prototype loads into a ParamTable", "[params]")
+{
+  auto sheet = Sweep::ReadRunsheetCSV("../params/runsheet_prototype.csv");
+
+  std::map<string, Param> params {};
+  mapShortNames(sheet, params);
+
+  REQUIRE_NOTHROW(ParamTable {params});
+}